@@ -0,0 +1,135 @@
+#pragma once
+
+#include "search.h"
+#include "search_workspace.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+struct PathQuery
+{
+    int start;
+    int finish;
+    HeuristicModes heuristic;
+};
+
+// Results of a batch, in query order.
+struct BatchResult
+{
+    // the path of query i is vertices[pathOffsets[i] .. pathOffsets[i + 1]),
+    // empty when there is no path; size_t, since millions of long paths
+    // overflow 32 bits
+    std::vector<size_t> pathOffsets;
+    std::vector<int> vertices;
+    // path costs, search::INF when there is no path
+    std::vector<int> distances;
+};
+
+namespace search
+{
+    // Runs A* for every query on the workers of "pool". The graph is only read,
+    // each worker has its own workspace, and each query carries its own
+    // heuristic. Workers start with equal slices of the queries and steal halves
+    // of each other's slices when they run dry, which balances queries of very
+    // different cost. The work ranges count queries in 32 bits, so larger batches
+    // throw std::length_error; split them up.
+    template <typename OpenSet = BinaryHeap, typename G>
+    BatchResult batchSearch(const G &g, const PathQuery *queries, size_t queryCount, ThreadPool &pool)
+    {
+        if (queryCount > std::numeric_limits<uint32_t>::max())
+            throw std::length_error("Too many queries for one batch");
+
+        const unsigned workerCount = pool.getThreadCount();
+        // small enough to balance, large enough to keep the range contention low
+        const uint32_t chunk = 16;
+
+        struct Worker
+        {
+            WorkRange range;
+            std::vector<int> vertices;
+        };
+        std::vector<Worker> workers(workerCount);
+
+        for (unsigned i = 0; i < workerCount; i++)
+        {
+            workers[i].range.assign(queryCount * i / workerCount, queryCount * (i + 1) / workerCount);
+        }
+
+        // where each query's path lives in the buffer of the worker that ran it
+        std::vector<uint32_t> owner(queryCount), length(queryCount);
+        std::vector<size_t> localOffset(queryCount);
+
+        BatchResult result;
+        result.distances.resize(queryCount);
+
+        pool.run([&](unsigned workerIndex)
+        {
+            Worker &self = workers[workerIndex];
+            SearchWorkspace<OpenSet> workspace;
+
+            while (true)
+            {
+                uint32_t begin, end;
+                while (self.range.takeFront(chunk, begin, end))
+                {
+                    for (uint32_t i = begin; i < end; i++)
+                    {
+                        const PathQuery &query = queries[i];
+                        owner[i] = workerIndex;
+                        localOffset[i] = self.vertices.size();
+
+                        if (aStarSearch(g, query.start, query.finish, query.heuristic, workspace))
+                        {
+                            self.vertices.insert(self.vertices.end(), workspace.path.begin(), workspace.path.end());
+                            result.distances[i] = workspace.getGScore(query.finish);
+                        }
+                        else
+                        {
+                            result.distances[i] = INF;
+                        }
+                        length[i] = self.vertices.size() - localOffset[i];
+                    }
+                }
+
+                // out of work, steal from the others
+                bool stolen = false;
+                for (unsigned k = 1; k < workerCount && !stolen; k++)
+                {
+                    Worker &victim = workers[(workerIndex + k) % workerCount];
+                    if (victim.range.stealBack(begin, end))
+                    {
+                        self.range.assign(begin, end);
+                        stolen = true;
+                    }
+                }
+                if (!stolen)
+                    return;
+            }
+        });
+
+        result.pathOffsets.resize(queryCount + 1);
+        result.pathOffsets[0] = 0;
+        for (size_t i = 0; i < queryCount; i++)
+        {
+            result.pathOffsets[i + 1] = result.pathOffsets[i] + length[i];
+        }
+
+        result.vertices.resize(result.pathOffsets[queryCount]);
+        for (size_t i = 0; i < queryCount; i++)
+        {
+            const std::vector<int> &source = workers[owner[i]].vertices;
+            std::copy(source.begin() + localOffset[i], source.begin() + localOffset[i] + length[i],
+                      result.vertices.begin() + result.pathOffsets[i]);
+        }
+
+        return result;
+    }
+
+    template <typename OpenSet = BinaryHeap, typename G>
+    BatchResult batchSearch(const G &g, const std::vector<PathQuery> &queries, ThreadPool &pool)
+    {
+        return batchSearch<OpenSet>(g, queries.data(), queries.size(), pool);
+    }
+}
@@ -0,0 +1,1772 @@
+#include "batch_search.h"
+#include "bitset_graph.h"
+#include "compact_graph.h"
+#include "components.h"
+#include "contraction_hierarchy.h"
+#include "csr_graph.h"
+#include "delta_stepping.h"
+#include "graph_generator.h"
+#include "graph.h"
+#include "graph_import.h"
+#include "grid_graph.h"
+#include "jump_table.h"
+#include "landmarks.h"
+#include "mapped_graph.h"
+#include "parallel_bfs.h"
+#include "reordering.h"
+#include "timer.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Headless benchmark of the point-to-point searches.
+//
+// Builds or loads one graph, draws a fixed set of random queries from the seed
+// and runs every algorithm on the same set. Each query is timed on its own
+// after a warm-up, so the report has latency percentiles rather than a single
+// sample, next to throughput, settled vertices, heap allocations per query and
+// the number of path costs that disagree with Dijkstra. --json writes the same
+// numbers in a machine-readable form for tracking regressions.
+
+namespace
+{
+    std::atomic<uint64_t> allocationCount{0};
+    std::atomic<uint64_t> allocatedBytes{0};
+
+    const char *usage =
+        "usage: bench [options]\n"
+        "  --vertices N        generated graph size (default 20000)\n"
+        "  --neighbors K       edges to the K nearest vertices (default 6)\n"
+        "  --radius R          edges to every vertex closer than R instead\n"
+        "  --seed S            seed of the graph and the queries (default 1)\n"
+        "  --dimacs FILE.gr    load a DIMACS graph instead, coordinates from --coordinates FILE.co\n"
+        "  --edges FILE        load a \"u v [weight]\" edge list instead\n"
+        "  --mapped FILE       map a graph file written by graphfile::save instead\n"
+        "  --queries Q         measured queries per algorithm (default 1000)\n"
+        "  --warmup W          unmeasured queries run first (default 50)\n"
+        "  --threads T         workers for generation, import and preprocessing (default all)\n"
+        "  --landmarks L       ALT landmarks (default 8)\n"
+        "  --algorithms LIST   comma separated subset of astar,heaps,bidirectional,alt,ch,batch\n"
+        "                      (default all but ch, whose preprocessing takes minutes on large graphs,\n"
+        "                      and batch, which runs every query in one batchSearch on --threads workers\n"
+        "                      and only has a mean; its paths must equal those of single queries)\n"
+        "                      bidirectional and alt assume undirected graphs and are skipped when an\n"
+        "                      imported graph has one-way arcs\n"
+        "  --sssp S            also time S whole-graph delta-stepping runs on 1, 2, 4, ... up to\n"
+        "                      --threads workers against djikstra (default 0, skipped)\n"
+        "  --delta D           bucket width of delta-stepping (default 4 x the mean arc weight)\n"
+        "  --bfs S             also time S direction-optimizing breadth-first searches on 1, 2, 4, ... up\n"
+        "                      to --threads workers against the serial one (default 0, skipped); needs\n"
+        "                      an undirected graph\n"
+        "  --orders LIST       also time euclideanBound A* on copies of the graph renumbered in the\n"
+        "                      comma separated subset of identity,hilbert,bfs,rcm (default none)\n"
+        "  --layouts LIST      also time euclideanBound A* on copies of the graph in the comma separated\n"
+        "                      subset of csr,compact,bitset and report their bytes per vertex and edge;\n"
+        "                      compact narrows the weights to 8 or 16 bits when they fit, bitset needs\n"
+        "                      at most 32768 vertices and weights equal to the coordinate distances\n"
+        "  --dense LIST        also time the matrix searches on a random 2000 vertex graph for each comma\n"
+        "                      separated edge density in percent, on every simd level the CPU supports,\n"
+        "                      against heap djikstra and edge by edge A* on the matrix and a bitset\n"
+        "  --dense-queries Q   queries per density and simd level (default 20)\n"
+        "  --grid N            also time grid A*, JPS and JPS+ on a random N x N grid with --queries\n"
+        "                      queries (default 0, skipped)\n"
+        "  --obstacles P       percent of blocked grid cells (default 25)\n"
+        "  --json FILE         write the results as JSON, - for stdout\n"
+        "Operation counts need a build configured with -DASTAR_ENABLE_STATS=ON, which also adds\n"
+        "some overhead; the default build only times the searches.\n";
+
+    struct Options
+    {
+        size_t vertexCount = 20000;
+        unsigned nearestNeighbors = 6;
+        int radius = 0;
+        uint64_t seed = 1;
+        std::string dimacsPath;
+        std::string coordinatePath;
+        std::string edgeListPath;
+        std::string mappedPath;
+        size_t queryCount = 1000;
+        size_t warmupCount = 50;
+        unsigned threadCount = 0;
+        unsigned landmarkCount = 8;
+        std::string algorithms = "astar,heaps,bidirectional,alt";
+        size_t ssspSources = 0;
+        int delta = 0;
+        size_t bfsSources = 0;
+        std::string orders;
+        std::string layouts;
+        std::string densities;
+        size_t denseQueryCount = 20;
+        uint32_t gridSize = 0;
+        int obstacleDensity = 25;
+        std::string jsonPath;
+    };
+
+    struct Query
+    {
+        int start;
+        int finish;
+    };
+
+    struct Measurement
+    {
+        std::string algorithm;
+        std::string heuristic;
+        std::string openSet;
+        double preprocessingMilliseconds = 0;
+        size_t found = 0;
+        size_t mismatches = 0;
+        double meanMicroseconds = 0;
+        double p50Microseconds = 0;
+        double p90Microseconds = 0;
+        double p99Microseconds = 0;
+        double maxMicroseconds = 0;
+        double queriesPerSecond = 0;
+        double meanSettled = 0;
+        // operation counts summed over the queries, zero without ASTAR_ENABLE_STATS
+        SearchStats totalStats;
+        double allocationsPerQuery = 0;
+        double allocatedBytesPerQuery = 0;
+    };
+
+    // whole-graph single-source runs at one worker count
+    struct ScalingMeasurement
+    {
+        unsigned threads = 0;
+        double meanMilliseconds = 0;
+        // relative to delta-stepping on one worker and to djikstra
+        double speedup = 0;
+        double speedupOverDijkstra = 0;
+        // sources whose distances differ from djikstra
+        size_t mismatches = 0;
+    };
+
+    struct ScalingReport
+    {
+        size_t sources = 0;
+        double dijkstraMilliseconds = 0;
+        std::vector<ScalingMeasurement> runs;
+    };
+
+    // whole-graph breadth-first searches at one worker count
+    struct BfsMeasurement
+    {
+        unsigned threads = 0;
+        double meanMilliseconds = 0;
+        // relative to the parallel search on one worker and to the serial one
+        double speedup = 0;
+        double speedupOverSerial = 0;
+        double meanBottomUpLevels = 0;
+        // sources whose depths differ from the serial search
+        size_t mismatches = 0;
+    };
+
+    struct BfsReport
+    {
+        size_t sources = 0;
+        double serialMilliseconds = 0;
+        std::vector<BfsMeasurement> runs;
+    };
+
+    // euclideanBound A* on the graph renumbered in one vertex order
+    struct OrderMeasurement
+    {
+        std::string order;
+        double reorderMilliseconds = 0;
+        Measurement search;
+        // relative to the identity order, or the first order measured without it
+        double speedup = 0;
+        // last level cache misses per query, -1 without a hardware counter
+        double cacheMissesPerQuery = -1;
+    };
+
+    // euclideanBound A* on one memory layout of the graph
+    struct LayoutMeasurement
+    {
+        std::string layout;
+        size_t totalBytes = 0;
+        double bytesPerVertex = 0;
+        double bytesPerEdge = 0;
+        Measurement search;
+        // relative to the first layout measured
+        double speedup = 0;
+    };
+
+    // one simd level of the matrix searches
+    struct DenseKernelMeasurement
+    {
+        std::string level;
+        double djikstraMilliseconds = 0;
+        double aStarMilliseconds = 0;
+        // djikstra relative to the heap djikstra
+        double speedup = 0;
+        // queries whose distances or path cost differ from the heap djikstra
+        size_t mismatches = 0;
+    };
+
+    // the matrix searches on one random graph of --dense
+    struct DenseMeasurement
+    {
+        int density = 0;
+        uint64_t arcCount = 0;
+        double heapDjikstraMilliseconds = 0;
+        std::vector<DenseKernelMeasurement> kernels;
+        // edge by edge A* on the int matrix and on the same edges as one bit per pair
+        double matrixAStarMilliseconds = 0;
+        double bitsetAStarMilliseconds = 0;
+        size_t edgeMismatches = 0;
+        double matrixBytesPerVertex = 0;
+        double matrixBytesPerEdge = 0;
+        double bitsetBytesPerVertex = 0;
+        double bitsetBytesPerEdge = 0;
+    };
+
+    // one search on the grid of --grid
+    struct GridMeasurement
+    {
+        std::string algorithm;
+        size_t tableBytes = 0;
+        Measurement search;
+        // relative to grid A*
+        double speedup = 0;
+    };
+
+    struct GridReport
+    {
+        uint32_t size = 0;
+        int obstacleDensity = 0;
+        std::vector<GridMeasurement> runs;
+    };
+
+    struct GraphInfo
+    {
+        std::string source;
+        uint32_t vertexCount = 0;
+        uint64_t arcCount = 0;
+        double loadMilliseconds = 0;
+        uint32_t componentCount = 0;
+        double componentMilliseconds = 0;
+        // some arc lacks a twin of the same weight, see search::isSymmetric
+        bool directed = false;
+    };
+
+    Options parseOptions(int argc, char *argv[])
+    {
+        Options options;
+        for (int i = 1; i < argc; i++)
+        {
+            std::string name = argv[i];
+            if (name == "--help" || name == "-h")
+            {
+                std::cout << usage;
+                std::exit(0);
+            }
+            if (i + 1 == argc)
+                throw std::invalid_argument("Missing value for " + name);
+            std::string value = argv[++i];
+
+            auto number = [&]()
+            {
+                size_t used = 0;
+                unsigned long long result = std::stoull(value, &used);
+                if (used != value.size())
+                    throw std::invalid_argument("Bad value for " + name + ": " + value);
+                return result;
+            };
+
+            if (name == "--vertices")
+                options.vertexCount = number();
+            else if (name == "--neighbors")
+                options.nearestNeighbors = number();
+            else if (name == "--radius")
+                options.radius = number();
+            else if (name == "--seed")
+                options.seed = number();
+            else if (name == "--dimacs")
+                options.dimacsPath = value;
+            else if (name == "--coordinates")
+                options.coordinatePath = value;
+            else if (name == "--edges")
+                options.edgeListPath = value;
+            else if (name == "--mapped")
+                options.mappedPath = value;
+            else if (name == "--queries")
+                options.queryCount = number();
+            else if (name == "--warmup")
+                options.warmupCount = number();
+            else if (name == "--threads")
+                options.threadCount = number();
+            else if (name == "--landmarks")
+                options.landmarkCount = number();
+            else if (name == "--algorithms")
+                options.algorithms = value;
+            else if (name == "--sssp")
+                options.ssspSources = number();
+            else if (name == "--delta")
+                options.delta = number();
+            else if (name == "--bfs")
+                options.bfsSources = number();
+            else if (name == "--orders")
+                options.orders = value;
+            else if (name == "--layouts")
+                options.layouts = value;
+            else if (name == "--dense")
+                options.densities = value;
+            else if (name == "--dense-queries")
+                options.denseQueryCount = number();
+            else if (name == "--grid")
+                options.gridSize = number();
+            else if (name == "--obstacles")
+                options.obstacleDensity = number();
+            else if (name == "--json")
+                options.jsonPath = value;
+            else
+                throw std::invalid_argument("Unknown option " + name);
+        }
+        return options;
+    }
+
+    bool isListed(const std::string &list, const std::string &name)
+    {
+        std::stringstream items(list);
+        std::string item;
+        while (std::getline(items, item, ','))
+        {
+            if (item == name)
+                return true;
+        }
+        return false;
+    }
+
+    bool isSelected(const Options &options, const std::string &algorithm)
+    {
+        return isListed(options.algorithms, algorithm);
+    }
+
+    // Counts the last level cache misses of this thread through perf_event_open.
+    // Unavailable off Linux, in most containers and with a restrictive
+    // perf_event_paranoid, in which case stop() returns 0.
+    class CacheMissCounter
+    {
+    private:
+        int fd = -1;
+
+    public:
+        CacheMissCounter()
+        {
+#ifdef __linux__
+            perf_event_attr attributes = {};
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.size = sizeof(attributes);
+            attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            fd = syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+#endif
+        }
+
+        ~CacheMissCounter()
+        {
+#ifdef __linux__
+            if (fd >= 0)
+                close(fd);
+#endif
+        }
+
+        CacheMissCounter(const CacheMissCounter &) = delete;
+        CacheMissCounter &operator=(const CacheMissCounter &) = delete;
+
+        bool isAvailable() const
+        {
+            return fd >= 0;
+        }
+
+        void start()
+        {
+#ifdef __linux__
+            if (fd >= 0)
+            {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        uint64_t stop()
+        {
+            uint64_t count = 0;
+#ifdef __linux__
+            if (fd >= 0)
+            {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                if (read(fd, &count, sizeof(count)) != sizeof(count))
+                    count = 0;
+            }
+#endif
+            return count;
+        }
+    };
+
+    // the same queries for every algorithm, drawn from the seed
+    std::vector<Query> makeQueries(uint32_t vertexCount, size_t count, uint64_t seed)
+    {
+        generator::SplitMix64 random(seed ^ 0x5EED);
+        std::vector<Query> queries(count);
+        for (Query &query : queries)
+        {
+            query.start = random.below(vertexCount);
+            query.finish = random.below(vertexCount);
+        }
+        return queries;
+    }
+
+    // cost of "path", -1 when it is empty
+    template <typename G>
+    int64_t getPathCost(const G &g, const std::vector<int> &path)
+    {
+        if (path.empty())
+            return -1;
+
+        int64_t cost = 0;
+        for (size_t i = 1; i < path.size(); i++)
+        {
+            int best = search::INF;
+            g.forEachNeighbor(path[i - 1], [&](int neighbor, int weight)
+            {
+                if (neighbor == path[i])
+                    best = std::min(best, weight);
+            });
+            cost += best;
+        }
+        return cost;
+    }
+
+    double getPercentile(const std::vector<uint64_t> &sorted, double fraction)
+    {
+        // nearest rank
+        size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+        return sorted[std::max<size_t>(rank, 1) - 1] / 1000.0;
+    }
+
+    // Runs "run(start, finish)" for the warm-up and then for every query,
+    // timing each one alone. "describe(settled, stats, cost)" is called after
+    // the clock stopped and reports what the last query did.
+    template <typename Run, typename Describe>
+    Measurement measure(const std::vector<Query> &queries, size_t warmupCount, const std::vector<int64_t> &reference,
+                        Run run, Describe describe)
+    {
+        for (size_t i = 0; i < warmupCount; i++)
+        {
+            const Query &query = queries[i % queries.size()];
+            run(query.start, query.finish);
+        }
+
+        Measurement result;
+        std::vector<uint64_t> nanoseconds(queries.size());
+        uint64_t totalSettled = 0;
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        Timer timer;
+
+        for (size_t i = 0; i < queries.size(); i++)
+        {
+            uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+            uint64_t bytesBefore = allocatedBytes.load(std::memory_order_relaxed);
+            timer.start();
+
+            bool found = run(queries[i].start, queries[i].finish);
+
+            nanoseconds[i] = timer.tickNanoseconds();
+            allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+            bytes += allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+
+            size_t settled = 0;
+            SearchStats stats;
+            int64_t cost = -1;
+            describe(settled, stats, cost);
+            if (!found)
+                cost = -1;
+
+            totalSettled += settled;
+            result.totalStats += stats;
+            result.found += found;
+            if (!reference.empty() && cost != reference[i])
+                result.mismatches++;
+        }
+
+        uint64_t total = 0;
+        for (uint64_t time : nanoseconds)
+        {
+            total += time;
+        }
+        std::sort(nanoseconds.begin(), nanoseconds.end());
+
+        const double count = queries.size();
+        result.meanMicroseconds = total / 1000.0 / count;
+        result.p50Microseconds = getPercentile(nanoseconds, 0.5);
+        result.p90Microseconds = getPercentile(nanoseconds, 0.9);
+        result.p99Microseconds = getPercentile(nanoseconds, 0.99);
+        result.maxMicroseconds = nanoseconds.back() / 1000.0;
+        result.queriesPerSecond = total > 0 ? count * 1e9 / total : 0;
+        result.meanSettled = totalSettled / count;
+        result.allocationsPerQuery = allocations / count;
+        result.allocatedBytesPerQuery = bytes / count;
+        return result;
+    }
+
+    template <typename OpenSet, typename G>
+    Measurement measureAStar(const G &g, HeuristicModes mode, const char *openSetName, const std::vector<Query> &queries,
+                             const Options &options, const std::vector<int64_t> &reference)
+    {
+        SearchWorkspace<OpenSet> workspace;
+        Measurement result = measure(queries, options.warmupCount, reference,
+                                     [&](int start, int finish)
+        {
+            return search::aStarSearch(g, start, finish, mode, workspace);
+        },
+                                     [&](size_t &settled, SearchStats &stats, int64_t &cost)
+        {
+            settled = workspace.settled;
+            stats = workspace.stats;
+            cost = getPathCost(g, workspace.path);
+        });
+
+        result.algorithm = mode == HeuristicModes::zero ? "dijkstra" : "astar";
+        result.heuristic = getHeuristicName(mode);
+        result.openSet = openSetName;
+        return result;
+    }
+
+    // costs of plain Dijkstra, every algorithm is checked against them
+    template <typename G>
+    std::vector<int64_t> getReferenceCosts(const G &g, const std::vector<Query> &queries)
+    {
+        std::vector<int64_t> reference;
+        SearchWorkspace<> workspace;
+        for (const Query &query : queries)
+        {
+            bool found = search::aStarSearch(g, query.start, query.finish, HeuristicModes::zero, workspace);
+            reference.push_back(found ? getPathCost(g, workspace.path) : -1);
+        }
+        return reference;
+    }
+
+    // Runs all queries as one euclideanBound batchSearch on "pool" and times the
+    // whole batch, so there is a mean but no percentiles. A query is wrong when
+    // its path or distance differs from the same query run alone.
+    template <typename G>
+    Measurement measureBatch(const G &g, const std::vector<Query> &queries, const Options &options, ThreadPool &pool)
+    {
+        std::vector<PathQuery> batch;
+        for (const Query &query : queries)
+        {
+            batch.push_back({query.start, query.finish, HeuristicModes::euclideanBound});
+        }
+        search::batchSearch(g, batch.data(), std::min(options.warmupCount, batch.size()), pool);
+
+        const uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        const uint64_t bytesBefore = allocatedBytes.load(std::memory_order_relaxed);
+        Timer timer;
+        timer.start();
+
+        const BatchResult paths = search::batchSearch(g, batch, pool);
+
+        const uint64_t nanoseconds = timer.tickNanoseconds();
+        const uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        const uint64_t bytes = allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+
+        Measurement result;
+        result.algorithm = "batch";
+        result.heuristic = "euclideanBound";
+        result.openSet = "binary";
+
+        SearchWorkspace<> workspace;
+        for (size_t i = 0; i < queries.size(); i++)
+        {
+            const bool found = paths.distances[i] != search::INF;
+            result.found += found;
+
+            const bool singleFound = search::aStarSearch(g, queries[i].start, queries[i].finish,
+                                                         HeuristicModes::euclideanBound, workspace);
+            const std::vector<int> single = singleFound ? workspace.path : std::vector<int>();
+            const bool samePath = std::equal(paths.vertices.begin() + paths.pathOffsets[i],
+                                             paths.vertices.begin() + paths.pathOffsets[i + 1], single.begin(),
+                                             single.end());
+            const int64_t singleCost = singleFound ? getPathCost(g, single) : -1;
+            if ((found ? paths.distances[i] : -1) != singleCost || !samePath)
+                result.mismatches++;
+        }
+
+        const double count = queries.size();
+        result.meanMicroseconds = nanoseconds / 1000.0 / count;
+        result.queriesPerSecond = nanoseconds > 0 ? count * 1e9 / nanoseconds : 0;
+        result.allocationsPerQuery = allocations / count;
+        result.allocatedBytesPerQuery = bytes / count;
+        return result;
+    }
+
+    // Runs the selected algorithms on the shared queries. Bidirectional A* and
+    // ALT assume d(u, v) = d(v, u) and are skipped on a directed graph, where
+    // they would report wrong costs; CH keeps in and out arcs apart and runs.
+    template <typename G>
+    void runSuite(const G &g, const Options &options, const GraphInfo &info, ThreadPool &pool,
+                  std::vector<Measurement> &results)
+    {
+        if (g.getVertexCount() == 0)
+            throw std::runtime_error("The graph is empty");
+
+        if (info.directed && (isSelected(options, "bidirectional") || isSelected(options, "alt")))
+            std::cerr << "The graph has one-way arcs, skipping bidirectional and alt\n";
+
+        const std::vector<Query> queries = makeQueries(g.getVertexCount(), options.queryCount, options.seed);
+        const std::vector<int64_t> reference = getReferenceCosts(g, queries);
+
+        results.push_back(measureAStar<BinaryHeap>(g, HeuristicModes::zero, "binary", queries, options, reference));
+
+        if (isSelected(options, "astar"))
+        {
+            for (HeuristicModes mode : {HeuristicModes::euclidean, HeuristicModes::euclideanBound,
+                                        HeuristicModes::xDifference, HeuristicModes::yDifference})
+            {
+                results.push_back(measureAStar<BinaryHeap>(g, mode, "binary", queries, options, reference));
+            }
+        }
+
+        if (isSelected(options, "heaps"))
+        {
+            results.push_back(measureAStar<QuaternaryHeap>(g, HeuristicModes::euclidean, "quaternary", queries,
+                                                           options, reference));
+            results.push_back(measureAStar<PairingHeap<>>(g, HeuristicModes::euclidean, "pairing", queries, options,
+                                                          reference));
+        }
+
+        if (isSelected(options, "bidirectional") && !info.directed)
+        {
+            BidirectionalWorkspace<> workspace;
+            Measurement result = measure(queries, options.warmupCount, reference,
+                                         [&](int start, int finish)
+            {
+                return search::bidirectionalAStarSearch(g, start, finish, HeuristicModes::euclidean, workspace);
+            },
+                                         [&](size_t &settled, SearchStats &stats, int64_t &cost)
+            {
+                settled = workspace.forward.settled + workspace.backward.settled;
+                stats = workspace.forward.stats;
+                stats += workspace.backward.stats;
+                cost = getPathCost(g, workspace.path);
+            });
+            result.algorithm = "bidirectional";
+            result.heuristic = "euclidean";
+            result.openSet = "binary";
+            results.push_back(result);
+        }
+
+        if (isSelected(options, "alt") && !info.directed)
+        {
+            Landmarks landmarks = Landmarks::build(g, options.landmarkCount, pool);
+            SearchWorkspace<> workspace;
+            Measurement result = measure(queries, options.warmupCount, reference,
+                                         [&](int start, int finish)
+            {
+                return search::aStarSearch(g, start, finish, AltHeuristic{&landmarks, finish}, workspace);
+            },
+                                         [&](size_t &settled, SearchStats &stats, int64_t &cost)
+            {
+                settled = workspace.settled;
+                stats = workspace.stats;
+                cost = getPathCost(g, workspace.path);
+            });
+            result.algorithm = "alt";
+            result.heuristic = "landmarks";
+            result.openSet = "binary";
+            result.preprocessingMilliseconds = landmarks.getPreprocessingMilliseconds();
+            results.push_back(result);
+        }
+
+        if (isSelected(options, "ch"))
+        {
+            ContractionHierarchy hierarchy = ContractionHierarchy::build(g, pool);
+            ChWorkspace workspace;
+            int distance = search::INF;
+            Measurement result = measure(queries, options.warmupCount, reference,
+                                         [&](int start, int finish)
+            {
+                distance = hierarchy.query(start, finish, workspace);
+                return distance != search::INF;
+            },
+                                         [&](size_t &settled, SearchStats &stats, int64_t &cost)
+            {
+                settled = workspace.forward.settled + workspace.backward.settled;
+                stats = workspace.forward.stats;
+                stats += workspace.backward.stats;
+                cost = distance;
+            });
+            result.algorithm = "ch";
+            result.heuristic = "none";
+            result.openSet = "binary";
+            result.preprocessingMilliseconds = hierarchy.getPreprocessingMilliseconds();
+            results.push_back(result);
+        }
+
+        if (isSelected(options, "batch"))
+            results.push_back(measureBatch(g, queries, options, pool));
+    }
+
+    // pools of 1, 2, 4, ... workers up to "maxThreads"
+    std::vector<std::unique_ptr<ThreadPool>> makePools(unsigned maxThreads)
+    {
+        std::vector<std::unique_ptr<ThreadPool>> pools;
+        for (unsigned threads = 1;; threads = std::min(threads * 2, maxThreads))
+        {
+            pools.emplace_back(new ThreadPool(threads));
+            if (threads >= maxThreads)
+                break;
+        }
+        return pools;
+    }
+
+    // Times whole-graph single-source runs from --sssp sources: djikstra once per
+    // source, then delta-stepping on 1, 2, 4, ... workers up to "maxThreads",
+    // each run checked against djikstra.
+    template <typename G>
+    ScalingReport measureScaling(const G &g, const Options &options, unsigned maxThreads)
+    {
+        ScalingReport report;
+        const uint32_t vertexCount = g.getVertexCount();
+        if (options.ssspSources == 0 || vertexCount == 0)
+            return report;
+
+        const std::vector<std::unique_ptr<ThreadPool>> pools = makePools(maxThreads);
+        report.runs.resize(pools.size());
+        for (size_t i = 0; i < pools.size(); i++)
+        {
+            report.runs[i].threads = pools[i]->getThreadCount();
+        }
+
+        const std::vector<Query> sources = makeQueries(vertexCount, options.ssspSources, options.seed);
+        std::vector<int> reference(vertexCount), distances(vertexCount);
+        std::vector<uint64_t> totals(pools.size(), 0);
+        uint64_t dijkstraTotal = 0;
+        Timer timer;
+
+        // untimed, wakes every pool up and pulls the graph into the caches
+        for (const std::unique_ptr<ThreadPool> &pool : pools)
+        {
+            search::deltaStepping(g, sources[0].start, distances.data(), *pool, options.delta);
+        }
+
+        for (const Query &source : sources)
+        {
+            timer.start();
+            search::djikstra(g, source.start, reference.data());
+            dijkstraTotal += timer.tickNanoseconds();
+
+            for (size_t i = 0; i < pools.size(); i++)
+            {
+                timer.start();
+                search::deltaStepping(g, source.start, distances.data(), *pools[i], options.delta);
+                totals[i] += timer.tickNanoseconds();
+                if (distances != reference)
+                    report.runs[i].mismatches++;
+            }
+        }
+
+        const double count = sources.size();
+        report.sources = sources.size();
+        report.dijkstraMilliseconds = dijkstraTotal / 1e6 / count;
+        for (size_t i = 0; i < report.runs.size(); i++)
+        {
+            ScalingMeasurement &run = report.runs[i];
+            run.meanMilliseconds = totals[i] / 1e6 / count;
+            run.speedup = totals[i] > 0 ? static_cast<double>(totals[0]) / totals[i] : 0;
+            run.speedupOverDijkstra = totals[i] > 0 ? static_cast<double>(dijkstraTotal) / totals[i] : 0;
+        }
+        return report;
+    }
+
+    // Times breadth-first searches from --bfs sources: the serial one once per
+    // source, then the parallel one on 1, 2, 4, ... workers up to "maxThreads",
+    // each checked against the serial depths. The bottom-up levels need
+    // undirected graphs, so directed ones are skipped.
+    template <typename G>
+    BfsReport measureBfs(const G &g, const Options &options, const GraphInfo &info, unsigned maxThreads)
+    {
+        BfsReport report;
+        const uint32_t vertexCount = g.getVertexCount();
+        if (options.bfsSources == 0 || vertexCount == 0)
+            return report;
+        if (info.directed)
+        {
+            std::cerr << "The graph has one-way arcs, skipping bfs\n";
+            return report;
+        }
+
+        const std::vector<std::unique_ptr<ThreadPool>> pools = makePools(maxThreads);
+        report.runs.resize(pools.size());
+        for (size_t i = 0; i < pools.size(); i++)
+        {
+            report.runs[i].threads = pools[i]->getThreadCount();
+        }
+
+        const std::vector<Query> sources = makeQueries(vertexCount, options.bfsSources, options.seed);
+        std::vector<int> reference(vertexCount), depths(vertexCount);
+        std::vector<uint64_t> totals(pools.size(), 0);
+        std::vector<uint64_t> bottomUpTotals(pools.size(), 0);
+        uint64_t serialTotal = 0;
+        TraversalWorkspace workspace;
+        Timer timer;
+
+        // untimed, wakes every pool up and pulls the graph into the caches
+        for (const std::unique_ptr<ThreadPool> &pool : pools)
+        {
+            search::parallelBreadthFirstSearch(g, sources[0].start, depths.data(), *pool);
+        }
+
+        for (const Query &source : sources)
+        {
+            std::fill(reference.begin(), reference.end(), search::INF);
+            timer.start();
+            search::breathFirstSearch(g, source.start, workspace, [&](int vertex, int depth)
+            {
+                reference[vertex] = depth;
+            });
+            serialTotal += timer.tickNanoseconds();
+
+            for (size_t i = 0; i < pools.size(); i++)
+            {
+                unsigned bottomUpLevels = 0;
+                timer.start();
+                search::parallelBreadthFirstSearch(g, source.start, depths.data(), *pools[i], &bottomUpLevels);
+                totals[i] += timer.tickNanoseconds();
+                bottomUpTotals[i] += bottomUpLevels;
+                if (depths != reference)
+                    report.runs[i].mismatches++;
+            }
+        }
+
+        const double count = sources.size();
+        report.sources = sources.size();
+        report.serialMilliseconds = serialTotal / 1e6 / count;
+        for (size_t i = 0; i < report.runs.size(); i++)
+        {
+            BfsMeasurement &run = report.runs[i];
+            run.meanMilliseconds = totals[i] / 1e6 / count;
+            run.speedup = totals[i] > 0 ? static_cast<double>(totals[0]) / totals[i] : 0;
+            run.speedupOverSerial = totals[i] > 0 ? static_cast<double>(serialTotal) / totals[i] : 0;
+            run.meanBottomUpLevels = bottomUpTotals[i] / count;
+        }
+        return report;
+    }
+
+    // Renumbers the graph in every order of --orders and times euclideanBound
+    // A* on each copy. The queries are the suite's, translated to internal ids,
+    // so only the memory layout differs and every path cost must still match
+    // Dijkstra on the original graph. Cache misses are counted in a second,
+    // untimed pass.
+    template <typename G>
+    std::vector<OrderMeasurement> measureOrders(const G &g, const Options &options)
+    {
+        std::vector<OrderMeasurement> results;
+        if (options.orders.empty() || g.getVertexCount() == 0)
+            return results;
+
+        const std::vector<Query> queries = makeQueries(g.getVertexCount(), options.queryCount, options.seed);
+        const std::vector<int64_t> reference = getReferenceCosts(g, queries);
+        CacheMissCounter counter;
+
+        for (int i = 0; i < static_cast<int>(VertexOrder::last); i++)
+        {
+            const VertexOrder order = static_cast<VertexOrder>(i);
+            if (!isListed(options.orders, getVertexOrderName(order)))
+                continue;
+
+            ReorderedGraph reordered = reorder::reorderGraph(g, order);
+            std::vector<Query> internalQueries = queries;
+            for (Query &query : internalQueries)
+            {
+                query.start = reordered.toInternal[query.start];
+                query.finish = reordered.toInternal[query.finish];
+            }
+
+            OrderMeasurement result;
+            result.order = getVertexOrderName(order);
+            result.reorderMilliseconds = reordered.reorderMilliseconds;
+            result.search = measureAStar<BinaryHeap>(reordered.graph, HeuristicModes::euclideanBound, "binary",
+                                                     internalQueries, options, reference);
+
+            if (counter.isAvailable())
+            {
+                SearchWorkspace<> workspace;
+                counter.start();
+                for (const Query &query : internalQueries)
+                {
+                    search::aStarSearch(reordered.graph, query.start, query.finish, HeuristicModes::euclideanBound,
+                                        workspace);
+                }
+                result.cacheMissesPerQuery = counter.stop() / static_cast<double>(internalQueries.size());
+            }
+            results.push_back(result);
+        }
+
+        if (results.empty())
+            throw std::invalid_argument("No known order in --orders " + options.orders);
+
+        const double baseline = results[0].search.meanMicroseconds;
+        for (OrderMeasurement &result : results)
+        {
+            result.speedup = result.search.meanMicroseconds > 0 ? baseline / result.search.meanMicroseconds : 0;
+        }
+        return results;
+    }
+
+    void printOrders(std::ostream &out, const std::vector<OrderMeasurement> &results)
+    {
+        out << "\neuclideanBound astar by vertex order\n";
+        out << std::left << std::setw(10) << "order" << std::right << std::setw(12) << "reorder ms" << std::setw(10)
+            << "mean us" << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "speedup"
+            << std::setw(14) << "misses/query" << std::setw(8) << "wrong"
+            << "\n";
+
+        for (const OrderMeasurement &result : results)
+        {
+            const Measurement &m = result.search;
+            out << std::left << std::setw(10) << result.order << std::right << std::fixed << std::setprecision(1)
+                << std::setw(12) << result.reorderMilliseconds << std::setw(10) << m.meanMicroseconds << std::setw(10)
+                << m.p50Microseconds << std::setw(10) << m.p99Microseconds << std::setprecision(2) << std::setw(10)
+                << result.speedup << std::setprecision(0) << std::setw(14);
+            if (result.cacheMissesPerQuery >= 0)
+                out << result.cacheMissesPerQuery;
+            else
+                out << "n/a";
+            out << std::setw(8) << m.mismatches << "\n";
+        }
+    }
+
+    // largest graph --layouts bitset accepts, its matrix then takes 128 MiB
+    const uint32_t maxBitsetVertices = 1 << 15;
+
+    // whether every weight of "g" is the distance between the endpoints, which
+    // a BitsetGraph derives instead of storing
+    template <typename G>
+    bool hasDistanceWeights(const G &g)
+    {
+        bool matches = true;
+        for (uint32_t v = 0; v < g.getVertexCount() && matches; v++)
+        {
+            g.forEachNeighbor(v, [&](int neighbor, int weight)
+            {
+                if (weight != getDistance(g.getCoordinate(v), g.getCoordinate(neighbor)))
+                    matches = false;
+            });
+        }
+        return matches;
+    }
+
+    template <typename Layout>
+    LayoutMeasurement measureLayout(const Layout &layout, const std::string &name, const std::vector<Query> &queries,
+                                    const Options &options, const std::vector<int64_t> &reference)
+    {
+        LayoutMeasurement result;
+        const MemoryUsage usage = layout.getMemoryUsage();
+        result.layout = name;
+        result.totalBytes = usage.getTotalBytes();
+        result.bytesPerVertex = usage.getBytesPerVertex(layout.getVertexCount());
+        result.bytesPerEdge = usage.getBytesPerEdge(layout.getEdgeCount());
+        result.search = measureAStar<BinaryHeap>(layout, HeuristicModes::euclideanBound, "binary", queries, options,
+                                                 reference);
+        return result;
+    }
+
+    // Copies the graph into every layout of --layouts and times euclideanBound
+    // A* on each with the suite's queries. The vertex ids stay the same, so the
+    // path costs must match Dijkstra on the original graph.
+    template <typename G>
+    std::vector<LayoutMeasurement> measureLayouts(const G &g, const Options &options)
+    {
+        std::vector<LayoutMeasurement> results;
+        if (options.layouts.empty() || g.getVertexCount() == 0)
+            return results;
+
+        const std::vector<Query> queries = makeQueries(g.getVertexCount(), options.queryCount, options.seed);
+        const std::vector<int64_t> reference = getReferenceCosts(g, queries);
+
+        if (isListed(options.layouts, "csr"))
+            results.push_back(measureLayout(CsrGraph::fromGraph(g), "csr", queries, options, reference));
+
+        if (isListed(options.layouts, "compact"))
+        {
+            if (CompactGraph<uint8_t>::canHold(g))
+                results.push_back(measureLayout(CompactGraph<uint8_t>::fromGraph(g), "compact8", queries, options,
+                                                reference));
+            else if (CompactGraph<uint16_t>::canHold(g))
+                results.push_back(measureLayout(CompactGraph<uint16_t>::fromGraph(g), "compact16", queries, options,
+                                                reference));
+            else
+                results.push_back(measureLayout(CompactGraph<int>::fromGraph(g), "compact32", queries, options,
+                                                reference));
+        }
+
+        if (isListed(options.layouts, "bitset"))
+        {
+            if (g.getVertexCount() > maxBitsetVertices || !hasDistanceWeights(g))
+                throw std::invalid_argument("--layouts bitset needs at most " + std::to_string(maxBitsetVertices) +
+                                            " vertices with the coordinate distances as weights");
+            results.push_back(measureLayout(BitsetGraph::fromGraph(g), "bitset", queries, options, reference));
+        }
+
+        if (results.empty())
+            throw std::invalid_argument("No known layout in --layouts " + options.layouts);
+
+        const double baseline = results[0].search.meanMicroseconds;
+        for (LayoutMeasurement &result : results)
+        {
+            result.speedup = result.search.meanMicroseconds > 0 ? baseline / result.search.meanMicroseconds : 0;
+        }
+        return results;
+    }
+
+    void printLayouts(std::ostream &out, const std::vector<LayoutMeasurement> &results)
+    {
+        out << "\neuclideanBound astar by memory layout\n";
+        out << std::left << std::setw(11) << "layout" << std::right << std::setw(12) << "MiB" << std::setw(12)
+            << "B/vertex" << std::setw(10) << "B/edge" << std::setw(10) << "mean us" << std::setw(10) << "p50"
+            << std::setw(10) << "p99" << std::setw(10) << "speedup" << std::setw(8) << "wrong"
+            << "\n";
+
+        for (const LayoutMeasurement &result : results)
+        {
+            const Measurement &m = result.search;
+            out << std::left << std::setw(11) << result.layout << std::right << std::fixed << std::setprecision(2)
+                << std::setw(12) << result.totalBytes / 1048576.0 << std::setw(12) << result.bytesPerVertex
+                << std::setw(10) << result.bytesPerEdge << std::setprecision(1) << std::setw(10)
+                << m.meanMicroseconds << std::setw(10) << m.p50Microseconds << std::setw(10) << m.p99Microseconds
+                << std::setprecision(2) << std::setw(10) << result.speedup << std::setw(8) << m.mismatches << "\n";
+        }
+    }
+
+    // side of the matrix of --dense, which takes 16 MB and lives on the heap
+    const size_t denseVertexCount = 2000;
+    // area the dense vertices are scattered over, the visualizer's window
+    const int denseWidth = 1200;
+    const int denseHeight = 960;
+
+    // Fills one random matrix graph per density of --dense and times the heap
+    // djikstra of search.h, then the matrix djikstra and A* on every simd level,
+    // then edge by edge A* on the matrix and on a BitsetGraph copy. Every run is
+    // checked against the heap djikstra.
+    std::vector<DenseMeasurement> measureDense(const Options &options)
+    {
+        std::vector<DenseMeasurement> results;
+        if (options.densities.empty())
+            return results;
+        if (options.denseQueryCount == 0)
+            throw std::invalid_argument("--dense-queries must be positive");
+
+        std::unique_ptr<Graph<denseVertexCount>> dense(new Graph<denseVertexCount>());
+        const std::vector<Query> queries = makeQueries(denseVertexCount, options.denseQueryCount, options.seed);
+        std::vector<std::vector<int>> reference(queries.size(), std::vector<int>(denseVertexCount));
+        std::vector<int> distances(denseVertexCount);
+        DenseWorkspace<> workspace;
+        SearchWorkspace<> edgeWorkspace;
+        Timer timer;
+        const double count = queries.size();
+
+        // the rounded euclidean heuristic can overestimate on these graphs, so
+        // the A* runs use the admissible bound and must match djikstra exactly
+        Graph<denseVertexCount>::setHeuristic(HeuristicModes::euclideanBound);
+
+        // whether the path found for query "i" costs something else than the reference
+        auto isWrong = [&](size_t i, bool found, const std::vector<int> &path)
+        {
+            const int expected = reference[i][queries[i].finish];
+            return (found ? getPathCost(*dense, path) : -1) != (expected == search::INF ? -1 : expected);
+        };
+
+        std::stringstream items(options.densities);
+        std::string item;
+        while (std::getline(items, item, ','))
+        {
+            DenseMeasurement result;
+            size_t used = 0;
+            try
+            {
+                result.density = std::stoi(item, &used);
+            }
+            catch (const std::exception &)
+            {
+                used = 0;
+            }
+            if (used == 0 || used != item.size() || result.density < 0 || result.density > 100)
+                throw std::invalid_argument("Bad density in --dense: " + item);
+
+            std::srand(options.seed);
+            dense->randomize(result.density, denseWidth, denseHeight);
+
+            uint64_t total = 0;
+            for (size_t i = 0; i < queries.size(); i++)
+            {
+                timer.start();
+                search::djikstra(*dense, queries[i].start, reference[i].data());
+                total += timer.tickNanoseconds();
+            }
+            result.heapDjikstraMilliseconds = total / 1e6 / count;
+
+            for (int level = 0; level <= static_cast<int>(simd::getSupportedLevel()); level++)
+            {
+                simd::setLevel(static_cast<SimdLevel>(level));
+                DenseKernelMeasurement kernel;
+                kernel.level = simd::getLevelName(simd::getLevel());
+                uint64_t djikstraTotal = 0;
+                uint64_t aStarTotal = 0;
+
+                for (size_t i = 0; i < queries.size(); i++)
+                {
+                    timer.start();
+                    dense->djikstra(queries[i].start, distances.data(), workspace);
+                    djikstraTotal += timer.tickNanoseconds();
+                    bool found = dense->aStarSearch(queries[i].start, queries[i].finish, workspace);
+                    aStarTotal += timer.tickNanoseconds();
+
+                    if (distances != reference[i] || isWrong(i, found, workspace.path))
+                        kernel.mismatches++;
+                }
+
+                kernel.djikstraMilliseconds = djikstraTotal / 1e6 / count;
+                kernel.aStarMilliseconds = aStarTotal / 1e6 / count;
+                kernel.speedup = djikstraTotal > 0 ? static_cast<double>(total) / djikstraTotal : 0;
+                result.kernels.push_back(kernel);
+            }
+            simd::setLevel(simd::getSupportedLevel());
+
+            const BitsetGraph bitset = BitsetGraph::fromGraph(*dense);
+            uint64_t matrixTotal = 0;
+            uint64_t bitsetTotal = 0;
+            for (size_t i = 0; i < queries.size(); i++)
+            {
+                timer.start();
+                bool found = dense->aStarSearch(queries[i].start, queries[i].finish, edgeWorkspace);
+                matrixTotal += timer.tickNanoseconds();
+                if (isWrong(i, found, edgeWorkspace.path))
+                    result.edgeMismatches++;
+
+                timer.start();
+                found = search::aStarSearch(bitset, queries[i].start, queries[i].finish, HeuristicModes::euclideanBound,
+                                            edgeWorkspace);
+                bitsetTotal += timer.tickNanoseconds();
+                if (isWrong(i, found, edgeWorkspace.path))
+                    result.edgeMismatches++;
+            }
+
+            const MemoryUsage matrixMemory = dense->getMemoryUsage();
+            const MemoryUsage bitsetMemory = bitset.getMemoryUsage();
+            result.arcCount = bitset.getEdgeCount();
+            result.matrixAStarMilliseconds = matrixTotal / 1e6 / count;
+            result.bitsetAStarMilliseconds = bitsetTotal / 1e6 / count;
+            result.matrixBytesPerVertex = matrixMemory.getBytesPerVertex(denseVertexCount);
+            result.matrixBytesPerEdge = matrixMemory.getBytesPerEdge(result.arcCount);
+            result.bitsetBytesPerVertex = bitsetMemory.getBytesPerVertex(denseVertexCount);
+            result.bitsetBytesPerEdge = bitsetMemory.getBytesPerEdge(result.arcCount);
+            results.push_back(result);
+        }
+        return results;
+    }
+
+    void printDense(std::ostream &out, const Options &options, const std::vector<DenseMeasurement> &results)
+    {
+        for (const DenseMeasurement &result : results)
+        {
+            out << "\ndense " << denseVertexCount << " vertices, " << result.density << "% density, "
+                << result.arcCount << " arcs, " << options.denseQueryCount << " queries; heap djikstra " << std::fixed
+                << std::setprecision(2) << result.heapDjikstraMilliseconds << " ms\n";
+            out << std::left << std::setw(10) << "kernel" << std::right << std::setw(14) << "djikstra ms"
+                << std::setw(10) << "speedup" << std::setw(10) << "A* ms" << std::setw(8) << "wrong"
+                << "\n";
+
+            for (const DenseKernelMeasurement &kernel : result.kernels)
+            {
+                out << std::left << std::setw(10) << kernel.level << std::right << std::setw(14)
+                    << kernel.djikstraMilliseconds << std::setw(10) << kernel.speedup << std::setw(10)
+                    << kernel.aStarMilliseconds << std::setw(8) << kernel.mismatches << "\n";
+            }
+
+            out << "edge by edge A*: int matrix " << result.matrixAStarMilliseconds << " ms, "
+                << result.matrixBytesPerVertex << " B/vertex, " << result.matrixBytesPerEdge << " B/edge; bitset "
+                << result.bitsetAStarMilliseconds << " ms, " << result.bitsetBytesPerVertex << " B/vertex, "
+                << result.bitsetBytesPerEdge << " B/edge; " << result.edgeMismatches << " wrong\n";
+        }
+    }
+
+    // random free cells of "grid" for --grid, the same ones for every algorithm
+    std::vector<Query> makeGridQueries(const GridGraph &grid, size_t count, uint64_t seed)
+    {
+        generator::SplitMix64 random(seed ^ 0x5EED);
+        auto getFreeCell = [&]()
+        {
+            int cell;
+            do
+            {
+                cell = random.below(grid.getVertexCount());
+            } while (grid.isBlocked(cell));
+            return cell;
+        };
+
+        std::vector<Query> queries(count);
+        for (Query &query : queries)
+        {
+            query.start = getFreeCell();
+            query.finish = getFreeCell();
+        }
+        return queries;
+    }
+
+    // Times octile grid A*, Jump Point Search and the JPS+ jump table on a
+    // random --grid grid, checked against Dijkstra on the grid.
+    GridReport measureGrid(const Options &options)
+    {
+        GridReport report;
+        if (options.gridSize == 0)
+            return report;
+        if (options.obstacleDensity < 0 || options.obstacleDensity >= 100)
+            throw std::invalid_argument("--obstacles must be below 100");
+
+        std::srand(options.seed);
+        const GridGraph grid = GridGraph::getRandomGrid(options.gridSize, options.gridSize, options.obstacleDensity);
+        const std::vector<Query> queries = makeGridQueries(grid, options.queryCount, options.seed);
+        const std::vector<int64_t> reference = getReferenceCosts(grid, queries);
+        report.size = options.gridSize;
+        report.obstacleDensity = options.obstacleDensity;
+
+        SearchWorkspace<> workspace;
+        auto describe = [&](size_t &settled, SearchStats &stats, int64_t &cost)
+        {
+            settled = workspace.settled;
+            stats = workspace.stats;
+            cost = getPathCost(grid, workspace.path);
+        };
+
+        GridMeasurement astar;
+        astar.algorithm = "astar";
+        astar.search = measure(queries, options.warmupCount, reference,
+                               [&](int start, int finish)
+        {
+            return grid.aStarSearch(start, finish, workspace);
+        },
+                               describe);
+        report.runs.push_back(astar);
+
+        GridMeasurement jps;
+        jps.algorithm = "jps";
+        jps.search = measure(queries, options.warmupCount, reference,
+                             [&](int start, int finish)
+        {
+            return grid.jumpPointSearch(start, finish, workspace);
+        },
+                             describe);
+        report.runs.push_back(jps);
+
+        const JumpTable table = JumpTable::build(grid);
+        GridMeasurement jumpTable;
+        jumpTable.algorithm = "jps+";
+        jumpTable.tableBytes = table.getTableBytes();
+        jumpTable.search = measure(queries, options.warmupCount, reference,
+                                   [&](int start, int finish)
+        {
+            return table.query(grid, start, finish, workspace);
+        },
+                                   describe);
+        jumpTable.search.preprocessingMilliseconds = table.getPreprocessingMilliseconds();
+        report.runs.push_back(jumpTable);
+
+        const double baseline = report.runs[0].search.meanMicroseconds;
+        for (GridMeasurement &run : report.runs)
+        {
+            run.speedup = run.search.meanMicroseconds > 0 ? baseline / run.search.meanMicroseconds : 0;
+        }
+        return report;
+    }
+
+    void printGrid(std::ostream &out, const GridReport &report)
+    {
+        out << "\ngrid " << report.size << " x " << report.size << ", " << report.obstacleDensity
+            << "% blocked\n";
+        out << std::left << std::setw(10) << "algorithm" << std::right << std::setw(10) << "mean us" << std::setw(10)
+            << "p50" << std::setw(10) << "p99" << std::setw(10) << "settled" << std::setw(10) << "speedup"
+            << std::setw(10) << "prep ms" << std::setw(12) << "table MiB" << std::setw(8) << "wrong"
+            << "\n";
+
+        for (const GridMeasurement &run : report.runs)
+        {
+            const Measurement &m = run.search;
+            out << std::left << std::setw(10) << run.algorithm << std::right << std::fixed << std::setprecision(1)
+                << std::setw(10) << m.meanMicroseconds << std::setw(10) << m.p50Microseconds << std::setw(10)
+                << m.p99Microseconds << std::setprecision(0) << std::setw(10) << m.meanSettled
+                << std::setprecision(2) << std::setw(10) << run.speedup << std::setprecision(1) << std::setw(10)
+                << m.preprocessingMilliseconds << std::setprecision(2) << std::setw(12)
+                << run.tableBytes / 1048576.0 << std::setw(8) << m.mismatches << "\n";
+        }
+    }
+
+    void printScaling(std::ostream &out, const Options &options, const ScalingReport &report)
+    {
+        out << "\nsssp from " << report.sources << " sources, delta "
+            << (options.delta > 0 ? std::to_string(options.delta) : "auto") << "; djikstra " << std::fixed
+            << std::setprecision(2) << report.dijkstraMilliseconds << " ms\n";
+        out << std::right << std::setw(8) << "threads" << std::setw(10) << "mean ms" << std::setw(10) << "speedup"
+            << std::setw(12) << "vs djikstra" << std::setw(8) << "wrong"
+            << "\n";
+
+        for (const ScalingMeasurement &run : report.runs)
+        {
+            out << std::setw(8) << run.threads << std::setprecision(2) << std::setw(10) << run.meanMilliseconds
+                << std::setw(10) << run.speedup << std::setw(12) << run.speedupOverDijkstra << std::setw(8)
+                << run.mismatches << "\n";
+        }
+    }
+
+    void printBfs(std::ostream &out, const BfsReport &report)
+    {
+        out << "\nbfs from " << report.sources << " sources; serial " << std::fixed << std::setprecision(2)
+            << report.serialMilliseconds << " ms\n";
+        out << std::right << std::setw(8) << "threads" << std::setw(10) << "mean ms" << std::setw(10) << "speedup"
+            << std::setw(12) << "vs serial" << std::setw(12) << "bottom-up" << std::setw(8) << "wrong"
+            << "\n";
+
+        for (const BfsMeasurement &run : report.runs)
+        {
+            out << std::setw(8) << run.threads << std::setprecision(2) << std::setw(10) << run.meanMilliseconds
+                << std::setw(10) << run.speedup << std::setw(12) << run.speedupOverSerial << std::setprecision(1)
+                << std::setw(12) << run.meanBottomUpLevels << std::setw(8) << run.mismatches << "\n";
+        }
+    }
+
+    // counts the components with the parallel labeling, queries between them
+    // fail without a search in the graphs that keep a ComponentIndex; also
+    // finds out whether the graph is directed
+    template <typename G>
+    void labelComponents(const G &g, ThreadPool &pool, GraphInfo &info)
+    {
+        Timer timer;
+        info.componentCount = components::labelComponents(g, pool).componentCount;
+        info.componentMilliseconds = timer.tick() / 1000.0;
+        info.directed = !search::isSymmetric(g);
+    }
+
+    void printTable(std::ostream &out, const GraphInfo &info, const Options &options,
+                    const std::vector<Measurement> &results)
+    {
+        out << info.source << ": " << info.vertexCount << " vertices, " << info.arcCount << " arcs, loaded in "
+            << std::fixed << std::setprecision(1) << info.loadMilliseconds << " ms; " << info.componentCount
+            << " components labeled in " << info.componentMilliseconds << " ms; "
+            << (info.directed ? "directed; " : "") << options.queryCount
+            << " queries after " << options.warmupCount << " warm-up\n";
+
+        out << std::left << std::setw(14) << "algorithm" << std::setw(15) << "heuristic" << std::setw(11) << "open set"
+            << std::right << std::setw(10) << "mean us" << std::setw(10) << "p50" << std::setw(10) << "p90"
+            << std::setw(10) << "p99" << std::setw(10) << "max" << std::setw(10) << "q/s" << std::setw(10)
+            << "settled" << std::setw(10) << "relaxed" << std::setw(8) << "allocs" << std::setw(8) << "wrong"
+            << std::setw(10) << "prep ms"
+            << "\n";
+
+        for (const Measurement &m : results)
+        {
+            out << std::left << std::setw(14) << m.algorithm << std::setw(15) << m.heuristic << std::setw(11)
+                << m.openSet << std::right << std::setprecision(1) << std::setw(10) << m.meanMicroseconds
+                << std::setw(10) << m.p50Microseconds << std::setw(10) << m.p90Microseconds << std::setw(10)
+                << m.p99Microseconds << std::setw(10) << m.maxMicroseconds << std::setprecision(0) << std::setw(10)
+                << m.queriesPerSecond << std::setw(10) << m.meanSettled << std::setw(10)
+                << m.totalStats.relaxed / static_cast<double>(options.queryCount) << std::setprecision(2) << std::setw(8)
+                << m.allocationsPerQuery << std::setw(8) << m.mismatches << std::setprecision(1) << std::setw(10)
+                << m.preprocessingMilliseconds << "\n";
+        }
+    }
+
+    std::string quote(const std::string &text)
+    {
+        std::string result = "\"";
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                result += '\\';
+            result += c;
+        }
+        return result + "\"";
+    }
+
+    void writeJson(std::ostream &out, const GraphInfo &info, const Options &options,
+                   const std::vector<Measurement> &results, const ScalingReport &scaling, const BfsReport &bfs,
+                   const std::vector<OrderMeasurement> &orders, const std::vector<LayoutMeasurement> &layouts,
+                   const std::vector<DenseMeasurement> &dense, const GridReport &grid)
+    {
+        out << std::setprecision(6) << std::defaultfloat;
+        out << "{\n";
+        out << "  \"graph\": {\"source\": " << quote(info.source) << ", \"vertices\": " << info.vertexCount
+            << ", \"arcs\": " << info.arcCount << ", \"loadMilliseconds\": " << info.loadMilliseconds
+            << ", \"components\": " << info.componentCount << ", \"componentMilliseconds\": " << info.componentMilliseconds
+            << ", \"directed\": " << (info.directed ? "true" : "false") << "},\n";
+        out << "  \"seed\": " << options.seed << ",\n";
+        out << "  \"queries\": " << options.queryCount << ",\n";
+        out << "  \"warmup\": " << options.warmupCount << ",\n";
+#ifdef ASTAR_ENABLE_STATS
+        out << "  \"statsEnabled\": true,\n";
+#else
+        out << "  \"statsEnabled\": false,\n";
+#endif
+        out << "  \"results\": [\n";
+        const double count = options.queryCount;
+
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const Measurement &m = results[i];
+            out << "    {\"algorithm\": " << quote(m.algorithm) << ", \"heuristic\": " << quote(m.heuristic)
+                << ", \"openSet\": " << quote(m.openSet) << ", \"preprocessingMilliseconds\": "
+                << m.preprocessingMilliseconds << ", \"found\": " << m.found << ", \"mismatches\": " << m.mismatches
+                << ", \"meanMicroseconds\": " << m.meanMicroseconds << ", \"p50Microseconds\": " << m.p50Microseconds
+                << ", \"p90Microseconds\": " << m.p90Microseconds << ", \"p99Microseconds\": " << m.p99Microseconds
+                << ", \"maxMicroseconds\": " << m.maxMicroseconds << ", \"queriesPerSecond\": " << m.queriesPerSecond
+                << ", \"meanSettled\": " << m.meanSettled << ", \"meanRelaxed\": " << m.totalStats.relaxed / count
+                << ", \"meanPushes\": " << m.totalStats.pushes / count << ", \"meanPops\": " << m.totalStats.pops / count
+                << ", \"meanDecreaseKeys\": " << m.totalStats.decreaseKeys / count
+                << ", \"meanHeuristicEvaluations\": " << m.totalStats.heuristicEvaluations / count
+                << ", \"meanPeakOpenSet\": " << m.totalStats.peakOpenSetSize / count
+                << ", \"allocationsPerQuery\": " << m.allocationsPerQuery
+                << ", \"allocatedBytesPerQuery\": " << m.allocatedBytesPerQuery << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+
+        out << "  ],\n";
+
+        out << "  \"sssp\": {\"sources\": " << scaling.sources << ", \"delta\": " << options.delta
+            << ", \"dijkstraMilliseconds\": " << scaling.dijkstraMilliseconds << ", \"runs\": [";
+        for (size_t i = 0; i < scaling.runs.size(); i++)
+        {
+            const ScalingMeasurement &run = scaling.runs[i];
+            out << (i > 0 ? ", " : "") << "{\"threads\": " << run.threads << ", \"meanMilliseconds\": "
+                << run.meanMilliseconds << ", \"speedup\": " << run.speedup << ", \"speedupOverDijkstra\": "
+                << run.speedupOverDijkstra << ", \"mismatches\": " << run.mismatches << "}";
+        }
+        out << "]},\n";
+
+        out << "  \"bfs\": {\"sources\": " << bfs.sources << ", \"serialMilliseconds\": " << bfs.serialMilliseconds
+            << ", \"runs\": [";
+        for (size_t i = 0; i < bfs.runs.size(); i++)
+        {
+            const BfsMeasurement &run = bfs.runs[i];
+            out << (i > 0 ? ", " : "") << "{\"threads\": " << run.threads << ", \"meanMilliseconds\": "
+                << run.meanMilliseconds << ", \"speedup\": " << run.speedup << ", \"speedupOverSerial\": "
+                << run.speedupOverSerial << ", \"meanBottomUpLevels\": " << run.meanBottomUpLevels
+                << ", \"mismatches\": " << run.mismatches << "}";
+        }
+        out << "]},\n";
+
+        out << "  \"orders\": [";
+        for (size_t i = 0; i < orders.size(); i++)
+        {
+            const OrderMeasurement &result = orders[i];
+            out << (i > 0 ? ", " : "") << "{\"order\": " << quote(result.order) << ", \"reorderMilliseconds\": "
+                << result.reorderMilliseconds << ", \"meanMicroseconds\": " << result.search.meanMicroseconds
+                << ", \"p50Microseconds\": " << result.search.p50Microseconds << ", \"p99Microseconds\": "
+                << result.search.p99Microseconds << ", \"speedup\": " << result.speedup
+                << ", \"cacheMissesPerQuery\": ";
+            if (result.cacheMissesPerQuery >= 0)
+                out << result.cacheMissesPerQuery;
+            else
+                out << "null";
+            out << ", \"mismatches\": " << result.search.mismatches << "}";
+        }
+        out << "],\n";
+
+        out << "  \"layouts\": [";
+        for (size_t i = 0; i < layouts.size(); i++)
+        {
+            const LayoutMeasurement &result = layouts[i];
+            out << (i > 0 ? ", " : "") << "{\"layout\": " << quote(result.layout) << ", \"totalBytes\": "
+                << result.totalBytes << ", \"bytesPerVertex\": " << result.bytesPerVertex << ", \"bytesPerEdge\": "
+                << result.bytesPerEdge << ", \"meanMicroseconds\": " << result.search.meanMicroseconds
+                << ", \"p50Microseconds\": " << result.search.p50Microseconds << ", \"p99Microseconds\": "
+                << result.search.p99Microseconds << ", \"speedup\": " << result.speedup << ", \"mismatches\": "
+                << result.search.mismatches << "}";
+        }
+        out << "],\n";
+
+        out << "  \"dense\": {\"vertices\": " << denseVertexCount << ", \"queries\": " << options.denseQueryCount
+            << ", \"graphs\": [";
+        for (size_t i = 0; i < dense.size(); i++)
+        {
+            const DenseMeasurement &result = dense[i];
+            out << (i > 0 ? ", " : "") << "{\"density\": " << result.density << ", \"arcs\": " << result.arcCount
+                << ", \"heapDjikstraMilliseconds\": " << result.heapDjikstraMilliseconds << ", \"kernels\": [";
+            for (size_t j = 0; j < result.kernels.size(); j++)
+            {
+                const DenseKernelMeasurement &kernel = result.kernels[j];
+                out << (j > 0 ? ", " : "") << "{\"level\": " << quote(kernel.level)
+                    << ", \"djikstraMilliseconds\": " << kernel.djikstraMilliseconds << ", \"aStarMilliseconds\": "
+                    << kernel.aStarMilliseconds << ", \"speedup\": " << kernel.speedup << ", \"mismatches\": "
+                    << kernel.mismatches << "}";
+            }
+            out << "], \"matrixAStarMilliseconds\": " << result.matrixAStarMilliseconds
+                << ", \"bitsetAStarMilliseconds\": " << result.bitsetAStarMilliseconds
+                << ", \"edgeMismatches\": " << result.edgeMismatches << ", \"matrixBytesPerVertex\": "
+                << result.matrixBytesPerVertex << ", \"matrixBytesPerEdge\": " << result.matrixBytesPerEdge
+                << ", \"bitsetBytesPerVertex\": " << result.bitsetBytesPerVertex << ", \"bitsetBytesPerEdge\": "
+                << result.bitsetBytesPerEdge << "}";
+        }
+        out << "]},\n";
+
+        out << "  \"grid\": {\"size\": " << grid.size << ", \"obstacles\": " << grid.obstacleDensity
+            << ", \"runs\": [";
+        for (size_t i = 0; i < grid.runs.size(); i++)
+        {
+            const GridMeasurement &run = grid.runs[i];
+            out << (i > 0 ? ", " : "") << "{\"algorithm\": " << quote(run.algorithm)
+                << ", \"preprocessingMilliseconds\": " << run.search.preprocessingMilliseconds
+                << ", \"tableBytes\": " << run.tableBytes << ", \"found\": " << run.search.found
+                << ", \"meanMicroseconds\": " << run.search.meanMicroseconds << ", \"p50Microseconds\": "
+                << run.search.p50Microseconds << ", \"p99Microseconds\": " << run.search.p99Microseconds
+                << ", \"meanSettled\": " << run.search.meanSettled << ", \"speedup\": " << run.speedup
+                << ", \"mismatches\": " << run.search.mismatches << "}";
+        }
+        out << "]}\n}\n";
+    }
+
+    // area for about one vertex per 20 x 20 units, at the 5:4 ratio of the window
+    generator::GeneratorOptions getGeneratorOptions(const Options &options)
+    {
+        generator::GeneratorOptions result;
+        result.vertexCount = options.vertexCount;
+        result.nearestNeighbors = options.nearestNeighbors;
+        result.radius = options.radius;
+        result.seed = options.seed;
+        result.height = std::max(960.0, std::sqrt(options.vertexCount * 400.0 / 1.25));
+        result.width = result.height * 1.25;
+        return result;
+    }
+}
+
+// Every global allocation form is replaced, so the array and over-aligned
+// ones are counted too and each delete releases memory from the matching new.
+// All of them go through countedAllocate/countedRelease, which are kept out of
+// line so the compiler pairs malloc with free instead of new with free.
+namespace
+{
+#if defined(__GNUC__)
+    __attribute__((noinline))
+#endif
+    void *countedAllocate(size_t size, size_t alignment)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        if (size == 0)
+            size = 1;
+
+        void *memory = nullptr;
+        if (alignment <= alignof(std::max_align_t))
+            memory = std::malloc(size);
+#if defined(__cpp_aligned_new) && !defined(_WIN32)
+        else if (posix_memalign(&memory, alignment, size) != 0)
+            memory = nullptr;
+#endif
+        if (!memory)
+            throw std::bad_alloc();
+        return memory;
+    }
+
+#if defined(__GNUC__)
+    __attribute__((noinline))
+#endif
+    void countedRelease(void *memory) noexcept
+    {
+        std::free(memory);
+    }
+}
+
+void *operator new(size_t size)
+{
+    return countedAllocate(size, alignof(std::max_align_t));
+}
+
+void *operator new[](size_t size)
+{
+    return countedAllocate(size, alignof(std::max_align_t));
+}
+
+void operator delete(void *memory) noexcept
+{
+    countedRelease(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    countedRelease(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    countedRelease(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept
+{
+    countedRelease(memory);
+}
+
+// Windows has no free() for over-aligned blocks, its default aligned forms stay
+#if defined(__cpp_aligned_new) && !defined(_WIN32)
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    return countedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+    return countedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept
+{
+    countedRelease(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t) noexcept
+{
+    countedRelease(memory);
+}
+
+void operator delete(void *memory, size_t, std::align_val_t) noexcept
+{
+    countedRelease(memory);
+}
+
+void operator delete[](void *memory, size_t, std::align_val_t) noexcept
+{
+    countedRelease(memory);
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        const Options options = parseOptions(argc, argv);
+        if (options.queryCount == 0)
+            throw std::invalid_argument("--queries must be positive");
+
+        ThreadPool pool(options.threadCount);
+        std::vector<Measurement> results;
+        ScalingReport scaling;
+        BfsReport bfs;
+        std::vector<OrderMeasurement> orders;
+        std::vector<LayoutMeasurement> layouts;
+        GraphInfo info;
+        Timer timer;
+
+        if (!options.mappedPath.empty())
+        {
+            MappedGraph g(options.mappedPath);
+            info = {"mapped " + options.mappedPath, g.getVertexCount(), g.getEdgeCount(), timer.tick() / 1000.0};
+            labelComponents(g, pool, info);
+            runSuite(g, options, info, pool, results);
+            scaling = measureScaling(g, options, pool.getThreadCount());
+            bfs = measureBfs(g, options, info, pool.getThreadCount());
+            orders = measureOrders(g, options);
+            layouts = measureLayouts(g, options);
+        }
+        else
+        {
+            CsrGraph g;
+            if (!options.dimacsPath.empty())
+            {
+                g = graphimport::importDimacs(options.dimacsPath, options.coordinatePath, pool);
+                info.source = "dimacs " + options.dimacsPath;
+            }
+            else if (!options.edgeListPath.empty())
+            {
+                g = graphimport::importEdgeList(options.edgeListPath, {}, pool);
+                info.source = "edge list " + options.edgeListPath;
+            }
+            else
+            {
+                g = CsrGraph::fromGraph(generator::generateGraph(getGeneratorOptions(options), pool));
+                info.source = "generated";
+            }
+            info.vertexCount = g.getVertexCount();
+            info.arcCount = g.getEdgeCount();
+            info.loadMilliseconds = timer.tick() / 1000.0;
+            labelComponents(g, pool, info);
+            runSuite(g, options, info, pool, results);
+            scaling = measureScaling(g, options, pool.getThreadCount());
+            bfs = measureBfs(g, options, info, pool.getThreadCount());
+            orders = measureOrders(g, options);
+            layouts = measureLayouts(g, options);
+        }
+
+        // both generate their own graphs
+        const std::vector<DenseMeasurement> dense = measureDense(options);
+        const GridReport grid = measureGrid(options);
+
+        if (options.jsonPath == "-")
+        {
+            printTable(std::cerr, info, options, results);
+            if (!scaling.runs.empty())
+                printScaling(std::cerr, options, scaling);
+            if (!bfs.runs.empty())
+                printBfs(std::cerr, bfs);
+            if (!orders.empty())
+                printOrders(std::cerr, orders);
+            if (!layouts.empty())
+                printLayouts(std::cerr, layouts);
+            if (!dense.empty())
+                printDense(std::cerr, options, dense);
+            if (!grid.runs.empty())
+                printGrid(std::cerr, grid);
+            writeJson(std::cout, info, options, results, scaling, bfs, orders, layouts, dense, grid);
+        }
+        else
+        {
+            printTable(std::cout, info, options, results);
+            if (!scaling.runs.empty())
+                printScaling(std::cout, options, scaling);
+            if (!bfs.runs.empty())
+                printBfs(std::cout, bfs);
+            if (!orders.empty())
+                printOrders(std::cout, orders);
+            if (!layouts.empty())
+                printLayouts(std::cout, layouts);
+            if (!dense.empty())
+                printDense(std::cout, options, dense);
+            if (!grid.runs.empty())
+                printGrid(std::cout, grid);
+            if (!options.jsonPath.empty())
+            {
+                std::ofstream file(options.jsonPath);
+                writeJson(file, info, options, results, scaling, bfs, orders, layouts, dense, grid);
+                if (!file)
+                    throw std::runtime_error("Cannot write " + options.jsonPath);
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << "\n" << usage;
+        return 1;
+    }
+    return 0;
+}
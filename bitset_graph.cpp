@@ -0,0 +1,80 @@
+#include "bitset_graph.h"
+#include <stdexcept>
+
+BitsetGraph::BitsetGraph(uint32_t capacity, BitsetWeights weights)
+    : capacity(capacity), wordsPerRow((static_cast<size_t>(capacity) + 63) / 64), weightMode(weights)
+{
+    rows.assign(wordsPerRow * capacity, 0);
+    coordinates.reserve(capacity);
+    vertexNames.reserve(capacity);
+}
+
+char BitsetGraph::getVertexName(int vertex) const
+{
+    return vertexNames[vertex];
+}
+
+uint32_t BitsetGraph::getVertexCount() const
+{
+    return vertexCount;
+}
+
+size_t BitsetGraph::getEdgeCount() const
+{
+    return arcCount;
+}
+
+const Point &BitsetGraph::getCoordinate(int vertex) const
+{
+    return coordinates[vertex];
+}
+
+void BitsetGraph::addVertex(char name, const Point &coordinate)
+{
+    if (vertexCount == capacity)
+        throw std::length_error("Bitset graph is full");
+
+    vertexNames.push_back(name);
+    coordinates.push_back(coordinate);
+    vertexCount++;
+}
+
+void BitsetGraph::addEdge(uint32_t i, uint32_t j)
+{
+    addArc(i, j);
+    addArc(j, i);
+}
+
+void BitsetGraph::addArc(uint32_t from, uint32_t to)
+{
+    if (from >= vertexCount || to >= vertexCount || from == to)
+        return;
+
+    uint64_t &word = rows[from * wordsPerRow + (to >> 6)];
+    const uint64_t bit = uint64_t(1) << (to & 63);
+    if (!(word & bit))
+    {
+        word |= bit;
+        arcCount++;
+    }
+}
+
+bool BitsetGraph::hasArc(int from, int to) const
+{
+    return rows[from * wordsPerRow + (to >> 6)] >> (to & 63) & 1;
+}
+
+int BitsetGraph::getWeight(int from, int to) const
+{
+    if (weightMode == BitsetWeights::unit)
+        return 1;
+    return getDistance(coordinates[from], coordinates[to]);
+}
+
+MemoryUsage BitsetGraph::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    usage.vertexBytes = coordinates.capacity() * sizeof(Point) + vertexNames.capacity() * sizeof(char);
+    usage.edgeBytes = rows.size() * sizeof(uint64_t);
+    return usage;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "geometry.h"
+#include "memory_usage.h"
+#include "search.h"
+#include <cstdint>
+#include <vector>
+
+// how a BitsetGraph derives the weight of an edge it stores as a single bit
+enum class BitsetWeights
+{
+    // getDistance between the endpoints, as Graph<N>::addEdge assigns them
+    distance,
+    // every edge costs 1
+    unit
+};
+
+// Dense adjacency matrix of one bit per vertex pair, for graphs whose weights
+// follow from the coordinates or are all equal. Next to Graph<N>'s matrix of
+// ints it is 32 times smaller, so a few thousand vertices fit in L2 and tens
+// of thousands in L3. forEachNeighbor walks the set bits a word at a time and
+// computes the weights on the fly.
+class BitsetGraph
+{
+private:
+    uint32_t capacity = 0;
+    uint32_t vertexCount = 0;
+    size_t wordsPerRow = 0;
+    size_t arcCount = 0;
+    std::vector<uint64_t> rows;
+    std::vector<Point> coordinates;
+    std::vector<char> vertexNames;
+    BitsetWeights weightMode = BitsetWeights::distance;
+
+public:
+    BitsetGraph() = default;
+
+    // room for "capacity" vertices, the matrix is allocated up front
+    explicit BitsetGraph(uint32_t capacity, BitsetWeights weights = BitsetWeights::distance);
+
+    // Copies the vertices and the arcs of "g"; its weights are dropped and
+    // derived from "weights" instead.
+    template <typename G>
+    static BitsetGraph fromGraph(const G &g, BitsetWeights weights = BitsetWeights::distance);
+
+    char getVertexName(int vertex) const;
+
+    uint32_t getVertexCount() const;
+
+    size_t getEdgeCount() const;
+
+    const Point &getCoordinate(int vertex) const;
+
+    // throws std::length_error once the capacity is used up
+    void addVertex(char name, const Point &coordinate);
+
+    // both directions
+    void addEdge(uint32_t i, uint32_t j);
+
+    void addArc(uint32_t from, uint32_t to);
+
+    bool hasArc(int from, int to) const;
+
+    int getWeight(int from, int to) const;
+
+    // calls f(neighbor, weight) for every edge leaving "vertex"
+    template <typename F>
+    void forEachNeighbor(int vertex, F f) const;
+
+    MemoryUsage getMemoryUsage() const;
+};
+
+template <typename G>
+BitsetGraph BitsetGraph::fromGraph(const G &g, BitsetWeights weights)
+{
+    const uint32_t count = g.getVertexCount();
+
+    BitsetGraph result(count, weights);
+    for (uint32_t v = 0; v < count; v++)
+    {
+        result.addVertex(g.getVertexName(v), g.getCoordinate(v));
+    }
+    for (uint32_t v = 0; v < count; v++)
+    {
+        g.forEachNeighbor(v, [&](int neighbor, int)
+        {
+            result.addArc(v, neighbor);
+        });
+    }
+    return result;
+}
+
+template <typename F>
+void BitsetGraph::forEachNeighbor(int vertex, F f) const
+{
+    const uint64_t *row = rows.data() + vertex * wordsPerRow;
+    const size_t usedWords = (static_cast<size_t>(vertexCount) + 63) / 64;
+
+    for (size_t word = 0; word < usedWords; word++)
+    {
+        for (uint64_t bits = row[word]; bits != 0; bits &= bits - 1)
+        {
+            const int neighbor = word * 64 + __builtin_ctzll(bits);
+            f(neighbor, getWeight(vertex, neighbor));
+        }
+    }
+}
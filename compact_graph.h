@@ -0,0 +1,131 @@
+#pragma once
+
+#include "geometry.h"
+#include "memory_usage.h"
+#include "search.h"
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Read-only CSR graph with the weights stored as WeightT, typically uint8_t or
+// uint16_t, for memory-bound searches on graphs whose weights are small. With
+// uint16_t an arc takes 6 bytes instead of CsrGraph's 8, and the hot per-vertex
+// data (offsets and coordinates) is kept apart from the names, which searches
+// never read. There is no spatial index either.
+//
+// Searches go through the free functions in search.h, forEachNeighbor widens
+// the weights back to int.
+template <typename WeightT>
+class CompactGraph
+{
+private:
+    std::vector<uint32_t> offsets = {0};
+    std::vector<uint32_t> neighbors;
+    std::vector<WeightT> weights;
+    std::vector<Point> coordinates;
+    std::vector<char> vertexNames;
+
+public:
+    CompactGraph() = default;
+
+    // whether every weight of "g" is in the range of WeightT
+    template <typename G>
+    static bool canHold(const G &g);
+
+    // copies "g", throws std::out_of_range when a weight does not fit WeightT
+    template <typename G>
+    static CompactGraph fromGraph(const G &g);
+
+    char getVertexName(int vertex) const
+    {
+        return vertexNames[vertex];
+    }
+
+    uint32_t getVertexCount() const
+    {
+        return coordinates.size();
+    }
+
+    size_t getEdgeCount() const
+    {
+        return neighbors.size();
+    }
+
+    const Point &getCoordinate(int vertex) const
+    {
+        return coordinates[vertex];
+    }
+
+    uint32_t getDegree(int vertex) const
+    {
+        return offsets[vertex + 1] - offsets[vertex];
+    }
+
+    // calls f(neighbor, weight) for every edge leaving "vertex"
+    template <typename F>
+    void forEachNeighbor(int vertex, F f) const
+    {
+        const uint32_t end = offsets[vertex + 1];
+        for (uint32_t i = offsets[vertex]; i < end; i++)
+        {
+            f(neighbors[i], static_cast<int>(weights[i]));
+        }
+    }
+
+    MemoryUsage getMemoryUsage() const
+    {
+        MemoryUsage usage;
+        usage.vertexBytes = offsets.size() * sizeof(uint32_t) + coordinates.size() * sizeof(Point) +
+                            vertexNames.size() * sizeof(char);
+        usage.edgeBytes = neighbors.size() * sizeof(uint32_t) + weights.size() * sizeof(WeightT);
+        return usage;
+    }
+};
+
+template <typename WeightT>
+template <typename G>
+bool CompactGraph<WeightT>::canHold(const G &g)
+{
+    bool fits = true;
+    for (uint32_t v = 0; v < g.getVertexCount() && fits; v++)
+    {
+        g.forEachNeighbor(v, [&](int, int weight)
+        {
+            if (weight < 0 || static_cast<int64_t>(weight) > std::numeric_limits<WeightT>::max())
+                fits = false;
+        });
+    }
+    return fits;
+}
+
+template <typename WeightT>
+template <typename G>
+CompactGraph<WeightT> CompactGraph<WeightT>::fromGraph(const G &g)
+{
+    const uint32_t vertexCount = g.getVertexCount();
+
+    CompactGraph result;
+    result.offsets.reserve(vertexCount + 1);
+    result.coordinates.resize(vertexCount);
+    result.vertexNames.resize(vertexCount);
+
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        result.vertexNames[v] = g.getVertexName(v);
+        result.coordinates[v] = g.getCoordinate(v);
+        g.forEachNeighbor(v, [&](int neighbor, int weight)
+        {
+            if (weight < 0 || static_cast<int64_t>(weight) > std::numeric_limits<WeightT>::max())
+                throw std::out_of_range("Weight " + std::to_string(weight) + " does not fit the compact graph");
+            result.neighbors.push_back(neighbor);
+            result.weights.push_back(static_cast<WeightT>(weight));
+        });
+        result.offsets.push_back(result.neighbors.size());
+    }
+
+    result.neighbors.shrink_to_fit();
+    result.weights.shrink_to_fit();
+    return result;
+}
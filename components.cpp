@@ -0,0 +1,104 @@
+#include "components.h"
+#include <utility>
+
+UnionFind::UnionFind(uint32_t elementCount) : parent(elementCount), sizes(elementCount, 1), setCount(elementCount)
+{
+    for (uint32_t i = 0; i < elementCount; i++)
+    {
+        parent[i] = i;
+    }
+}
+
+uint32_t UnionFind::addElement()
+{
+    parent.push_back(parent.size());
+    sizes.push_back(1);
+    setCount++;
+    return parent.size() - 1;
+}
+
+uint32_t UnionFind::find(uint32_t element)
+{
+    uint32_t root = element;
+    while (parent[root] != root)
+    {
+        root = parent[root];
+    }
+
+    // point the whole path at the root
+    while (parent[element] != root)
+    {
+        uint32_t up = parent[element];
+        parent[element] = root;
+        element = up;
+    }
+    return root;
+}
+
+bool UnionFind::unite(uint32_t a, uint32_t b)
+{
+    a = find(a);
+    b = find(b);
+    if (a == b)
+        return false;
+
+    if (sizes[a] < sizes[b])
+        std::swap(a, b);
+    parent[b] = a;
+    sizes[a] += sizes[b];
+    setCount--;
+    return true;
+}
+
+void ComponentIndex::clear()
+{
+    componentOf.clear();
+    next.clear();
+    sizes.clear();
+    componentCount = 0;
+}
+
+void ComponentIndex::reserve(size_t vertexCount)
+{
+    componentOf.reserve(vertexCount);
+    next.reserve(vertexCount);
+    sizes.reserve(vertexCount);
+}
+
+void ComponentIndex::addVertex()
+{
+    uint32_t vertex = componentOf.size();
+    componentOf.push_back(vertex);
+    next.push_back(vertex);
+    sizes.push_back(1);
+    componentCount++;
+}
+
+void ComponentIndex::connect(uint32_t i, uint32_t j)
+{
+    uint32_t kept = componentOf[i];
+    uint32_t merged = componentOf[j];
+    if (kept == merged)
+        return;
+
+    if (sizes[kept] < sizes[merged])
+    {
+        std::swap(kept, merged);
+        std::swap(i, j);
+    }
+
+    // j is in the smaller component, relabel its cycle
+    uint32_t vertex = j;
+    do
+    {
+        componentOf[vertex] = kept;
+        vertex = next[vertex];
+    } while (vertex != j);
+
+    // exchanging the successors of one member of each cycle joins the cycles
+    std::swap(next[i], next[j]);
+
+    sizes[kept] += sizes[merged];
+    sizes[merged] = 0;
+    componentCount--;
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Disjoint sets over the ids 0 .. getSize() - 1, union by size with path
+// compression, so a sequence of operations costs nearly O(1) each.
+class UnionFind
+{
+private:
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> sizes;
+    uint32_t setCount = 0;
+
+public:
+    explicit UnionFind(uint32_t elementCount = 0);
+
+    // adds an element in a set of its own and returns its id
+    uint32_t addElement();
+
+    // representative of the set of "element"
+    uint32_t find(uint32_t element);
+
+    // merges the sets of a and b, returns false when they already were one
+    bool unite(uint32_t a, uint32_t b);
+
+    uint32_t getSize() const
+    {
+        return parent.size();
+    }
+
+    uint32_t getSetCount() const
+    {
+        return setCount;
+    }
+};
+
+// Component ids kept up to date while edges are only ever added.
+//
+// Every vertex starts as a component of its own. An edge between two
+// components relabels the smaller one, walking a circular list of its members,
+// so each vertex is relabeled O(log V) times over all insertions and a lookup
+// is a single load. Arcs count in both directions: with one-way arcs these are
+// the weakly connected components, and a shared id is necessary for a path but
+// no longer sufficient.
+class ComponentIndex
+{
+private:
+    std::vector<uint32_t> componentOf;
+    // next[v] is the next member of v's component, the members form a cycle
+    std::vector<uint32_t> next;
+    // member count by component id, 0 for ids merged away
+    std::vector<uint32_t> sizes;
+    uint32_t componentCount = 0;
+
+public:
+    void clear();
+
+    void reserve(size_t vertexCount);
+
+    // adds the next vertex as a component of its own
+    void addVertex();
+
+    // merges the components of i and j
+    void connect(uint32_t i, uint32_t j);
+
+    // ids are those of a vertex of the component, not dense
+    uint32_t getComponent(uint32_t vertex) const
+    {
+        return componentOf[vertex];
+    }
+
+    bool isConnected(uint32_t i, uint32_t j) const
+    {
+        return componentOf[i] == componentOf[j];
+    }
+
+    uint32_t getComponentSize(uint32_t vertex) const
+    {
+        return sizes[componentOf[vertex]];
+    }
+
+    uint32_t getComponentCount() const
+    {
+        return componentCount;
+    }
+};
+
+// Component ids numbered 0 .. componentCount - 1 in the order of each
+// component's smallest vertex, so both labelings below agree exactly.
+struct ComponentLabels
+{
+    std::vector<uint32_t> labels;
+    uint32_t componentCount = 0;
+};
+
+// Offline labeling of whole graphs. Both variants treat arcs as undirected, so
+// for the one-way arcs of DynamicGraph::addArc they find the weakly connected
+// components.
+namespace components
+{
+    // one pass over the arcs with a UnionFind
+    template <typename G>
+    ComponentLabels labelComponents(const G &g)
+    {
+        const uint32_t vertexCount = g.getVertexCount();
+        UnionFind sets(vertexCount);
+
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            g.forEachNeighbor(v, [&](int neighbor, int)
+            {
+                sets.unite(v, neighbor);
+            });
+        }
+
+        // the first vertex seen of every set is its smallest
+        ComponentLabels result;
+        result.labels.resize(vertexCount);
+        std::vector<uint32_t> idOfRoot(vertexCount, UINT32_MAX);
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            uint32_t &id = idOfRoot[sets.find(v)];
+            if (id == UINT32_MAX)
+                id = result.componentCount++;
+            result.labels[v] = id;
+        }
+        return result;
+    }
+
+    // Label propagation on the workers of "pool". Every vertex starts with its
+    // own id as label and each round lowers the labels of a vertex and of its
+    // neighbors to the least label among them, then lets every vertex jump to
+    // the label of its label. Labels only ever name a vertex of the component,
+    // so the rounds stop with every vertex labeled by the smallest vertex of its
+    // component. Jumping takes long chains down in a few rounds rather than one
+    // round per vertex of the diameter.
+    template <typename G>
+    ComponentLabels labelComponents(const G &g, ThreadPool &pool)
+    {
+        const uint32_t vertexCount = g.getVertexCount();
+        const unsigned workerCount = pool.getThreadCount();
+
+        std::vector<std::atomic<uint32_t>> labels(vertexCount);
+        std::atomic<bool> changed{true};
+
+        auto lower = [&](uint32_t vertex, uint32_t label)
+        {
+            uint32_t old = labels[vertex].load(std::memory_order_relaxed);
+            while (label < old)
+            {
+                if (labels[vertex].compare_exchange_weak(old, label, std::memory_order_relaxed))
+                    return true;
+            }
+            return false;
+        };
+
+        pool.run([&](unsigned workerIndex)
+        {
+            const uint32_t begin = static_cast<uint64_t>(vertexCount) * workerIndex / workerCount;
+            const uint32_t end = static_cast<uint64_t>(vertexCount) * (workerIndex + 1) / workerCount;
+            for (uint32_t v = begin; v < end; v++)
+            {
+                labels[v].store(v, std::memory_order_relaxed);
+            }
+        });
+
+        while (changed.load())
+        {
+            changed.store(false);
+
+            pool.run([&](unsigned workerIndex)
+            {
+                const uint32_t begin = static_cast<uint64_t>(vertexCount) * workerIndex / workerCount;
+                const uint32_t end = static_cast<uint64_t>(vertexCount) * (workerIndex + 1) / workerCount;
+                bool lowered = false;
+
+                for (uint32_t v = begin; v < end; v++)
+                {
+                    uint32_t least = labels[v].load(std::memory_order_relaxed);
+                    g.forEachNeighbor(v, [&](int neighbor, int)
+                    {
+                        least = std::min(least, labels[neighbor].load(std::memory_order_relaxed));
+                    });
+
+                    // the neighbors too, so one-way arcs propagate both ways
+                    lowered |= lower(v, least);
+                    g.forEachNeighbor(v, [&](int neighbor, int)
+                    {
+                        lowered |= lower(neighbor, least);
+                    });
+                }
+
+                for (uint32_t v = begin; v < end; v++)
+                {
+                    uint32_t label = labels[v].load(std::memory_order_relaxed);
+                    lowered |= lower(v, labels[label].load(std::memory_order_relaxed));
+                }
+
+                if (lowered)
+                    changed.store(true);
+            });
+        }
+
+        // a smallest vertex keeps its own id as label and comes before the rest
+        ComponentLabels result;
+        result.labels.resize(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            uint32_t label = labels[v].load(std::memory_order_relaxed);
+            result.labels[v] = label == v ? result.componentCount++ : result.labels[label];
+        }
+        return result;
+    }
+}
@@ -0,0 +1,421 @@
+#include "contraction_hierarchy.h"
+#include "search.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+
+namespace
+{
+    // vertices a witness search may settle before giving up and keeping the shortcut,
+    // priorities only estimate the shortcut count so they use a cheaper search
+    const size_t CONTRACTION_SETTLE_LIMIT = 500;
+    const size_t PRIORITY_SETTLE_LIMIT = 20;
+
+    struct Edge
+    {
+        uint32_t vertex;
+        int weight;
+        int middle;
+    };
+
+    // the not yet contracted part of the graph
+    class Contractor
+    {
+    public:
+        std::vector<std::vector<Edge>> out;
+        std::vector<std::vector<Edge>> in;
+        std::vector<uint32_t> deletedNeighbors;
+        // depth of the hierarchy below each vertex
+        std::vector<uint32_t> level;
+
+        explicit Contractor(uint32_t vertexCount)
+            : out(vertexCount), in(vertexCount), deletedNeighbors(vertexCount, 0), level(vertexCount, 0)
+        {
+        }
+
+        // adds u -> x, or lowers its weight if it already exists
+        // returns false when the existing arc was already as short
+        bool addArc(uint32_t u, uint32_t x, int weight, int middle)
+        {
+            for (Edge &edge : out[u])
+            {
+                if (edge.vertex == x)
+                {
+                    if (edge.weight <= weight)
+                        return false;
+
+                    edge.weight = weight;
+                    edge.middle = middle;
+                    for (Edge &reverse : in[x])
+                    {
+                        if (reverse.vertex == u)
+                        {
+                            reverse.weight = weight;
+                            reverse.middle = middle;
+                        }
+                    }
+                    return true;
+                }
+            }
+
+            out[u].push_back({x, weight, middle});
+            in[x].push_back({u, weight, middle});
+            return true;
+        }
+
+        // Shortest distances from "source" in the remaining graph without "skip".
+        // Exact up to "maxDistance" for every vertex settled before the limit; the
+        // search also stops once "targetCount" out-neighbors of "skip" are settled.
+        void witnessSearch(uint32_t source, uint32_t skip, int maxDistance, size_t targetCount,
+                           size_t settleLimit, SearchWorkspace<> &workspace) const
+        {
+            workspace.reset(out.size());
+            workspace.setScore(source, 0, -1);
+            workspace.openSet.push(source, 0);
+
+            size_t settled = 0;
+            while (!workspace.openSet.empty() && settled < settleLimit && targetCount > 0)
+            {
+                if (workspace.openSet.topKey() > maxDistance)
+                    break;
+
+                uint32_t vertex = workspace.openSet.pop();
+                settled++;
+
+                if (vertex != source)
+                {
+                    for (const Edge &target : out[skip])
+                    {
+                        if (target.vertex == vertex)
+                            targetCount--;
+                    }
+                }
+
+                int distance = workspace.getGScore(vertex);
+                for (const Edge &edge : out[vertex])
+                {
+                    if (edge.vertex == skip)
+                        continue;
+
+                    int newDistance = distance + edge.weight;
+                    if (newDistance < workspace.getGScore(edge.vertex))
+                    {
+                        workspace.setScore(edge.vertex, newDistance, vertex);
+                        workspace.openSet.push(edge.vertex, newDistance);
+                    }
+                }
+            }
+        }
+
+        // calls emit(u, x, weight) for every shortcut contracting "vertex" needs
+        template <typename F>
+        void forEachShortcut(uint32_t vertex, size_t settleLimit, SearchWorkspace<> &workspace, F emit) const
+        {
+            for (const Edge &incoming : in[vertex])
+            {
+                int maxOut = 0;
+                size_t targetCount = 0;
+                for (const Edge &outgoing : out[vertex])
+                {
+                    if (outgoing.vertex != incoming.vertex)
+                    {
+                        maxOut = std::max(maxOut, outgoing.weight);
+                        targetCount++;
+                    }
+                }
+                if (targetCount == 0)
+                    continue;
+
+                witnessSearch(incoming.vertex, vertex, incoming.weight + maxOut, targetCount, settleLimit, workspace);
+
+                for (const Edge &outgoing : out[vertex])
+                {
+                    if (outgoing.vertex == incoming.vertex)
+                        continue;
+
+                    int viaVertex = incoming.weight + outgoing.weight;
+                    if (workspace.getGScore(outgoing.vertex) > viaVertex)
+                        emit(incoming.vertex, outgoing.vertex, viaVertex);
+                }
+            }
+        }
+
+        // edge difference, deleted neighbors and level; lower is contracted first
+        int priority(uint32_t vertex, SearchWorkspace<> &workspace) const
+        {
+            int shortcuts = 0;
+            forEachShortcut(vertex, PRIORITY_SETTLE_LIMIT, workspace, [&](uint32_t, uint32_t, int)
+            {
+                shortcuts++;
+            });
+
+            int edgeDifference = shortcuts - static_cast<int>(in[vertex].size() + out[vertex].size());
+            return 2 * edgeDifference + static_cast<int>(deletedNeighbors[vertex] + level[vertex]);
+        }
+
+        static void removeArc(std::vector<Edge> &edges, uint32_t vertex)
+        {
+            edges.erase(std::remove_if(edges.begin(), edges.end(), [&](const Edge &edge)
+            {
+                return edge.vertex == vertex;
+            }), edges.end());
+        }
+    };
+}
+
+ContractionHierarchy ContractionHierarchy::buildFromArcs(uint32_t vertexCount, const std::vector<CsrGraph::Arc> &arcs, ThreadPool &pool)
+{
+    auto begin = std::chrono::steady_clock::now();
+
+    Contractor contractor(vertexCount);
+    for (const CsrGraph::Arc &arc : arcs)
+    {
+        if (arc.from >= vertexCount || arc.to >= vertexCount)
+            throw std::out_of_range("Arc references a missing vertex");
+        if (arc.from != arc.to)
+            contractor.addArc(arc.from, arc.to, arc.weight, -1);
+    }
+
+    // initial priorities only read the graph, so every worker simulates its own slice
+    std::vector<int> priority(vertexCount);
+    const unsigned workerCount = pool.getThreadCount();
+    pool.run([&](unsigned workerIndex)
+    {
+        SearchWorkspace<> workspace;
+        uint32_t first = static_cast<uint64_t>(vertexCount) * workerIndex / workerCount;
+        uint32_t last = static_cast<uint64_t>(vertexCount) * (workerIndex + 1) / workerCount;
+        for (uint32_t vertex = first; vertex < last; vertex++)
+        {
+            priority[vertex] = contractor.priority(vertex, workspace);
+        }
+    });
+
+    using Entry = std::pair<int, uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        queue.push({priority[vertex], vertex});
+    }
+
+    ContractionHierarchy result;
+    result.rank.assign(vertexCount, 0);
+    std::vector<bool> contracted(vertexCount, false);
+    // arcs each vertex keeps when it is contracted, all of them lead upward
+    std::vector<std::vector<Edge>> up(vertexCount), down(vertexCount);
+    SearchWorkspace<> workspace;
+    std::vector<uint32_t> neighbors;
+    uint32_t nextRank = 0;
+
+    while (!queue.empty())
+    {
+        Entry entry = queue.top();
+        queue.pop();
+        uint32_t vertex = entry.second;
+
+        // skip stale entries left behind by priority updates
+        if (contracted[vertex] || entry.first != priority[vertex])
+            continue;
+
+        // lazy update: the priority may have grown since it was queued
+        int current = contractor.priority(vertex, workspace);
+        if (current != priority[vertex])
+        {
+            priority[vertex] = current;
+            if (!queue.empty() && current > queue.top().first)
+            {
+                queue.push({current, vertex});
+                continue;
+            }
+        }
+
+        std::vector<CsrGraph::Arc> shortcuts;
+        contractor.forEachShortcut(vertex, CONTRACTION_SETTLE_LIMIT, workspace, [&](uint32_t u, uint32_t x, int weight)
+        {
+            shortcuts.push_back({u, x, weight});
+        });
+        for (const CsrGraph::Arc &shortcut : shortcuts)
+        {
+            if (contractor.addArc(shortcut.from, shortcut.to, shortcut.weight, vertex))
+                result.shortcutCount++;
+        }
+
+        contracted[vertex] = true;
+        result.rank[vertex] = nextRank++;
+        up[vertex] = std::move(contractor.out[vertex]);
+        down[vertex] = std::move(contractor.in[vertex]);
+        contractor.out[vertex].clear();
+        contractor.in[vertex].clear();
+
+        for (const Edge &edge : up[vertex])
+        {
+            Contractor::removeArc(contractor.in[edge.vertex], vertex);
+        }
+        for (const Edge &edge : down[vertex])
+        {
+            Contractor::removeArc(contractor.out[edge.vertex], vertex);
+        }
+
+        // neighbors lost an edge and may need other shortcuts now
+        neighbors.clear();
+        for (const Edge &edge : up[vertex])
+        {
+            neighbors.push_back(edge.vertex);
+        }
+        for (const Edge &edge : down[vertex])
+        {
+            neighbors.push_back(edge.vertex);
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+        for (uint32_t neighbor : neighbors)
+        {
+            contractor.deletedNeighbors[neighbor]++;
+            contractor.level[neighbor] = std::max(contractor.level[neighbor], contractor.level[vertex] + 1);
+
+            int updated = contractor.priority(neighbor, workspace);
+            if (updated != priority[neighbor])
+            {
+                priority[neighbor] = updated;
+                queue.push({updated, neighbor});
+            }
+        }
+    }
+
+    auto pack = [&](const std::vector<std::vector<Edge>> &lists, std::vector<uint32_t> &offsets, std::vector<Arc> &packed)
+    {
+        offsets.assign(vertexCount + 1, 0);
+        for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+        {
+            offsets[vertex + 1] = offsets[vertex] + lists[vertex].size();
+            for (const Edge &edge : lists[vertex])
+            {
+                packed.push_back({edge.vertex, edge.weight, edge.middle});
+            }
+        }
+    };
+    pack(up, result.upOffsets, result.upward);
+    pack(down, result.downOffsets, result.downward);
+
+    auto end = std::chrono::steady_clock::now();
+    result.preprocessingMilliseconds = std::chrono::duration<double, std::milli>(end - begin).count();
+
+    return result;
+}
+
+const ContractionHierarchy::Arc &ContractionHierarchy::findUpward(uint32_t from, uint32_t to) const
+{
+    for (uint32_t i = upOffsets[from]; i < upOffsets[from + 1]; i++)
+    {
+        if (upward[i].vertex == to)
+            return upward[i];
+    }
+    throw std::logic_error("Missing upward arc");
+}
+
+const ContractionHierarchy::Arc &ContractionHierarchy::findDownward(uint32_t from, uint32_t to) const
+{
+    for (uint32_t i = downOffsets[to]; i < downOffsets[to + 1]; i++)
+    {
+        if (downward[i].vertex == from)
+            return downward[i];
+    }
+    throw std::logic_error("Missing downward arc");
+}
+
+void ContractionHierarchy::unpack(uint32_t from, uint32_t to, int middle, std::vector<int> &path) const
+{
+    if (middle == -1)
+    {
+        path.push_back(to);
+        return;
+    }
+
+    // the middle vertex ranks below both ends, so from -> middle is one of its
+    // downward arcs and middle -> to one of its upward arcs
+    unpack(from, middle, findDownward(from, middle).middle, path);
+    unpack(middle, to, findUpward(middle, to).middle, path);
+}
+
+int ContractionHierarchy::query(int start, int finish, ChWorkspace &workspace) const
+{
+    SearchWorkspace<> &forward = workspace.forward;
+    SearchWorkspace<> &backward = workspace.backward;
+
+    forward.reset(getVertexCount());
+    backward.reset(getVertexCount());
+    workspace.path.clear();
+
+    forward.setScore(start, 0, -1);
+    forward.push(start, 0);
+    backward.setScore(finish, 0, -1);
+    backward.push(finish, 0);
+
+    int best = search::INF;
+    int meeting = -1;
+
+    // one step of either direction, "other" is only read to find meeting points
+    auto step = [&](SearchWorkspace<> &self, const SearchWorkspace<> &other,
+                    const std::vector<uint32_t> &offsets, const std::vector<Arc> &arcs)
+    {
+        int vertex = self.settle();
+        int distance = self.getGScore(vertex);
+
+        if (other.isReached(vertex) && distance + other.getGScore(vertex) < best)
+        {
+            best = distance + other.getGScore(vertex);
+            meeting = vertex;
+        }
+
+        for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; i++)
+        {
+            ASTAR_STATS(self.stats.relaxed++);
+            int newDistance = distance + arcs[i].weight;
+            if (newDistance < self.getGScore(arcs[i].vertex))
+            {
+                self.setScore(arcs[i].vertex, newDistance, vertex);
+                self.push(arcs[i].vertex, newDistance);
+            }
+        }
+    };
+
+    while (true)
+    {
+        // a direction is done once nothing it could still settle beats "best"
+        bool forwardActive = !forward.openSet.empty() && forward.openSet.topKey() < best;
+        bool backwardActive = !backward.openSet.empty() && backward.openSet.topKey() < best;
+
+        if (!forwardActive && !backwardActive)
+            break;
+
+        if (forwardActive)
+            step(forward, backward, upOffsets, upward);
+        if (backwardActive)
+            step(backward, forward, downOffsets, downward);
+    }
+
+    if (meeting == -1)
+        return search::INF;
+
+    // start -> meeting climbs upward arcs
+    std::vector<int> &path = workspace.path;
+    forward.reconstructPath(meeting);
+    path.push_back(start);
+    for (size_t i = 1; i < forward.path.size(); i++)
+    {
+        uint32_t from = forward.path[i - 1], to = forward.path[i];
+        unpack(from, to, findUpward(from, to).middle, path);
+    }
+
+    // meeting -> finish descends, the backward search stored it in reverse
+    for (int vertex = meeting; vertex != finish;)
+    {
+        int next = backward.getCameFrom(vertex);
+        unpack(vertex, next, findDownward(vertex, next).middle, path);
+        vertex = next;
+    }
+
+    return best;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "csr_graph.h"
+#include "search_workspace.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <vector>
+
+// scratch state of ContractionHierarchy::query, one per thread
+using ChWorkspace = BidirectionalWorkspace<>;
+
+// Contraction Hierarchies for fast point-to-point queries on a static graph.
+//
+// Preprocessing contracts the vertices one by one in order of importance and
+// inserts a shortcut u -> x whenever removing v would destroy the only shortest
+// path u -> v -> x. The result is split into an upward graph (arcs to higher
+// ranked vertices) and a downward graph (arcs from higher ranked vertices,
+// stored reversed), both in CSR form. A query then only has to run two small
+// Dijkstra searches that climb the hierarchy from the start and the finish.
+class ContractionHierarchy
+{
+private:
+    struct Arc
+    {
+        uint32_t vertex;
+        int weight;
+        // contracted vertex a shortcut skips, -1 for an original edge
+        int middle;
+    };
+
+    std::vector<uint32_t> rank;
+    // upward[upOffsets[v] ..] are the arcs v -> vertex with rank[vertex] > rank[v]
+    std::vector<uint32_t> upOffsets;
+    std::vector<Arc> upward;
+    // downward[downOffsets[v] ..] are the arcs vertex -> v with rank[vertex] > rank[v]
+    std::vector<uint32_t> downOffsets;
+    std::vector<Arc> downward;
+    size_t shortcutCount = 0;
+    double preprocessingMilliseconds = 0;
+
+    static ContractionHierarchy buildFromArcs(uint32_t vertexCount, const std::vector<CsrGraph::Arc> &arcs, ThreadPool &pool);
+
+    // appends the original vertices of arc from -> to, "from" excluded
+    void unpack(uint32_t from, uint32_t to, int middle, std::vector<int> &path) const;
+
+    const Arc &findUpward(uint32_t from, uint32_t to) const;
+    const Arc &findDownward(uint32_t from, uint32_t to) const;
+
+public:
+    // Contracts "g". Vertex priorities are first computed in parallel on "pool",
+    // the contraction itself then updates them lazily.
+    template <typename G>
+    static ContractionHierarchy build(const G &g, ThreadPool &pool);
+
+    uint32_t getVertexCount() const
+    {
+        return rank.size();
+    }
+
+    uint32_t getRank(int vertex) const
+    {
+        return rank[vertex];
+    }
+
+    size_t getShortcutCount() const
+    {
+        return shortcutCount;
+    }
+
+    double getPreprocessingMilliseconds() const
+    {
+        return preprocessingMilliseconds;
+    }
+
+    // Returns the distance from "start" to "finish", search::INF when there is
+    // no path, and leaves the unpacked vertex path in workspace.path.
+    int query(int start, int finish, ChWorkspace &workspace) const;
+};
+
+template <typename G>
+ContractionHierarchy ContractionHierarchy::build(const G &g, ThreadPool &pool)
+{
+    std::vector<CsrGraph::Arc> arcs;
+    for (uint32_t i = 0; i < g.getVertexCount(); i++)
+    {
+        g.forEachNeighbor(i, [&](int neighbor, int weight)
+        {
+            arcs.push_back({i, static_cast<uint32_t>(neighbor), weight});
+        });
+    }
+
+    return buildFromArcs(g.getVertexCount(), arcs, pool);
+}
@@ -0,0 +1,172 @@
+#include "csr_graph.h"
+#include <iostream>
+#include <stdexcept>
+
+HeuristicModes CsrGraph::heuristicMode = HeuristicModes::euclidean;
+
+CsrGraph::CsrGraph(std::vector<char> names, std::vector<Point> coordinates, const std::vector<Arc> &arcs)
+    : vertexNames(std::move(names)), coordinates(std::move(coordinates))
+{
+    const size_t vertexCount = this->coordinates.size();
+
+    if (vertexNames.size() != vertexCount)
+        throw std::invalid_argument("Vertex names and coordinates differ in size");
+
+    // counting sort of the arcs by source vertex
+    offsets.assign(vertexCount + 1, 0);
+    for (const Arc &arc : arcs)
+    {
+        if (arc.from >= vertexCount || arc.to >= vertexCount)
+            throw std::out_of_range("Arc references a missing vertex");
+        offsets[arc.from + 1]++;
+    }
+
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+
+    neighbors.resize(arcs.size());
+    weights.resize(arcs.size());
+
+    std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+    for (const Arc &arc : arcs)
+    {
+        uint32_t slot = next[arc.from]++;
+        neighbors[slot] = arc.to;
+        weights[slot] = arc.weight;
+    }
+}
+
+CsrGraph::CsrGraph(std::vector<char> names, std::vector<Point> coordinates, std::vector<uint32_t> offsets,
+                   std::vector<uint32_t> neighbors, std::vector<int> weights)
+    : offsets(std::move(offsets)), neighbors(std::move(neighbors)), weights(std::move(weights)),
+      vertexNames(std::move(names)), coordinates(std::move(coordinates))
+{
+    const size_t vertexCount = this->coordinates.size();
+
+    if (vertexNames.size() != vertexCount)
+        throw std::invalid_argument("Vertex names and coordinates differ in size");
+    if (this->offsets.size() != vertexCount + 1 || this->offsets[0] != 0 ||
+        this->offsets.back() != this->neighbors.size() || this->neighbors.size() != this->weights.size())
+        throw std::invalid_argument("CSR arrays do not match the vertex count");
+
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        if (this->offsets[i] > this->offsets[i + 1])
+            throw std::invalid_argument("CSR offsets must not decrease");
+    }
+    for (uint32_t neighbor : this->neighbors)
+    {
+        if (neighbor >= vertexCount)
+            throw std::out_of_range("Arc references a missing vertex");
+    }
+}
+
+void CsrGraph::setHeuristic(HeuristicModes heuristic)
+{
+    heuristicMode = heuristic;
+}
+
+char CsrGraph::getVertexName(int vertex) const
+{
+    return vertexNames[vertex];
+}
+
+uint32_t CsrGraph::getVertexCount() const
+{
+    return coordinates.size();
+}
+
+size_t CsrGraph::getEdgeCount() const
+{
+    return neighbors.size();
+}
+
+MemoryUsage CsrGraph::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    usage.vertexBytes = offsets.size() * sizeof(uint32_t) + coordinates.size() * sizeof(Point) +
+                        vertexNames.size() * sizeof(char);
+    usage.edgeBytes = neighbors.size() * sizeof(uint32_t) + weights.size() * sizeof(int);
+    if (std::shared_ptr<const SpatialIndex> index = std::atomic_load(&spatialIndex))
+        usage.indexBytes = index->getMemoryBytes();
+    return usage;
+}
+
+const Point &CsrGraph::getCoordinate(int vertex) const
+{
+    return coordinates[vertex];
+}
+
+const SpatialIndex &CsrGraph::getSpatialIndex() const
+{
+    std::shared_ptr<const SpatialIndex> index = std::atomic_load(&spatialIndex);
+    if (index)
+        return *index;
+
+    std::shared_ptr<SpatialIndex> built = std::make_shared<SpatialIndex>();
+    for (size_t i = 0; i < coordinates.size(); i++)
+    {
+        built->insert(i, coordinates[i]);
+    }
+
+    // a thread that raced us may have published its index first, keep that one
+    std::shared_ptr<const SpatialIndex> expected;
+    if (std::atomic_compare_exchange_strong(&spatialIndex, &expected, std::shared_ptr<const SpatialIndex>(built)))
+        return *built;
+    return *expected;
+}
+
+uint32_t CsrGraph::getDegree(int vertex) const
+{
+    return offsets[vertex + 1] - offsets[vertex];
+}
+
+void CsrGraph::print() const
+{
+    for (uint32_t i = 0; i < getVertexCount(); i++)
+    {
+        std::cout << vertexNames[i] << ":";
+        forEachNeighbor(i, [&](int neighbor, int weight)
+        {
+            std::cout << " " << vertexNames[neighbor] << "(" << weight << ")";
+        });
+        std::cout << "\n";
+    }
+}
+
+int CsrGraph::getNearbyVertex(const Point &pos) const
+{
+    return getSpatialIndex().nearest(pos, SNAP_DISTANCE);
+}
+
+std::vector<int> CsrGraph::depthFirstSearch(int start) const
+{
+    return search::depthFirstOrder(*this, start);
+}
+
+std::vector<int> CsrGraph::breathFirstSearch(int start) const
+{
+    return search::breadthFirstOrder(*this, start);
+}
+
+bool CsrGraph::isConnected() const
+{
+    return search::isConnected(*this);
+}
+
+std::vector<int> CsrGraph::djikstra(int start) const
+{
+    return search::djikstra(*this, start);
+}
+
+size_t CsrGraph::djikstra(int start, int *distances, const search::DijkstraLimits &limits) const
+{
+    return search::djikstra(*this, start, distances, limits);
+}
+
+int CsrGraph::heuristic(int current, int finish) const
+{
+    return search::heuristic(*this, heuristicMode, current, finish);
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "geometry.h"
+#include "memory_usage.h"
+#include "search.h"
+#include "spatial_index.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Compressed sparse row graph: the neighbors of vertex v are
+// neighbors[offsets[v] .. offsets[v + 1]) with matching weights, so memory is
+// O(V + E) and neighbor expansion is O(degree).
+//
+// The layout is immutable; build it from a list of arcs or from any other
+// graph type with CsrGraph::fromGraph. The spatial index for snapping is only
+// built on the first getNearbyVertex or getSpatialIndex call, imports and
+// reorderings that never snap do not pay for it.
+class CsrGraph
+{
+public:
+    // directed edge, add both directions for an undirected graph
+    struct Arc
+    {
+        uint32_t from;
+        uint32_t to;
+        int weight;
+    };
+
+private:
+    std::vector<uint32_t> offsets = {0};
+    std::vector<uint32_t> neighbors;
+    std::vector<int> weights;
+    std::vector<char> vertexNames;
+    std::vector<Point> coordinates;
+    // built once on demand and shared by copies, the graph never changes
+    mutable std::shared_ptr<const SpatialIndex> spatialIndex;
+    static HeuristicModes heuristicMode;
+
+public:
+    CsrGraph() = default;
+
+    CsrGraph(std::vector<char> names, std::vector<Point> coordinates, const std::vector<Arc> &arcs);
+
+    // takes over CSR arrays built elsewhere, such as by the streaming importers;
+    // offsets has one entry per vertex plus the final arc count
+    CsrGraph(std::vector<char> names, std::vector<Point> coordinates, std::vector<uint32_t> offsets,
+             std::vector<uint32_t> neighbors, std::vector<int> weights);
+
+    template <typename G>
+    static CsrGraph fromGraph(const G &g);
+
+    static void setHeuristic(HeuristicModes);
+
+    char getVertexName(int vertex) const;
+
+    uint32_t getVertexCount() const;
+
+    size_t getEdgeCount() const;
+
+    const Point &getCoordinate(int vertex) const;
+
+    // builds the index on the first call, safe to call from several threads
+    const SpatialIndex &getSpatialIndex() const;
+
+    uint32_t getDegree(int vertex) const;
+
+    MemoryUsage getMemoryUsage() const;
+
+    // calls f(neighbor, weight) for every edge leaving "vertex"
+    template <typename F>
+    void forEachNeighbor(int vertex, F f) const;
+
+    void print() const;
+
+    // closest vertex within SNAP_DISTANCE of "pos", -1 if there is none
+    int getNearbyVertex(const Point &pos) const;
+
+    // vertices reachable from "start", in depth-first discovery order
+    std::vector<int> depthFirstSearch(int start) const;
+
+    // vertices reachable from "start", in breadth-first order
+    std::vector<int> breathFirstSearch(int start) const;
+
+    bool isConnected() const;
+
+    std::vector<int> djikstra(int start) const;
+
+    size_t djikstra(int start, int *distances, const search::DijkstraLimits &limits = {}) const;
+
+    int heuristic(int current, int finish) const;
+
+    template <typename OpenSet = BinaryHeap>
+    std::vector<int> aStarSearch(int start, int finish) const;
+
+    // allocation-free variant, the path is left in workspace.path
+    template <typename OpenSet>
+    bool aStarSearch(int start, int finish, SearchWorkspace<OpenSet> &workspace) const;
+};
+
+template <typename G>
+CsrGraph CsrGraph::fromGraph(const G &g)
+{
+    const uint32_t vertexCount = g.getVertexCount();
+
+    std::vector<char> names(vertexCount);
+    std::vector<Point> coordinates(vertexCount);
+    std::vector<Arc> arcs;
+
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        names[i] = g.getVertexName(i);
+        coordinates[i] = g.getCoordinate(i);
+        g.forEachNeighbor(i, [&](int neighbor, int weight)
+        {
+            arcs.push_back({i, static_cast<uint32_t>(neighbor), weight});
+        });
+    }
+
+    return CsrGraph(std::move(names), std::move(coordinates), arcs);
+}
+
+template <typename OpenSet>
+std::vector<int> CsrGraph::aStarSearch(int start, int finish) const
+{
+    return search::aStarSearch<OpenSet>(*this, start, finish, heuristicMode);
+}
+
+template <typename OpenSet>
+bool CsrGraph::aStarSearch(int start, int finish, SearchWorkspace<OpenSet> &workspace) const
+{
+    return search::aStarSearch(*this, start, finish, heuristicMode, workspace);
+}
+
+template <typename F>
+void CsrGraph::forEachNeighbor(int vertex, F f) const
+{
+    const uint32_t end = offsets[vertex + 1];
+    for (uint32_t i = offsets[vertex]; i < end; i++)
+    {
+        f(neighbors[i], weights[i]);
+    }
+}
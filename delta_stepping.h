@@ -0,0 +1,225 @@
+#pragma once
+
+#include "search.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace search
+{
+    // Parallel single-source shortest paths by delta-stepping.
+    //
+    // Tentative distances are grouped into buckets of width "delta" that are
+    // settled in increasing order, the way Dijkstra settles single vertices. The
+    // vertices of the lowest non-empty bucket relax their light arcs (weight <=
+    // delta) in parallel, again and again until the bucket stays empty, and then
+    // their heavy arcs once. Distances are lowered with compare-and-swap, so no
+    // worker ever locks, and every worker keeps its own buckets of the vertices
+    // it improved. The whole search runs inside one ThreadPool::run, with the
+    // workers meeting at a barrier between phases.
+    //
+    // The result equals djikstra for non-negative weights. A small delta does
+    // little work that is later undone but needs many phases, a large one needs
+    // few phases but relaxes vertices before their distance is final. 0 picks four
+    // times the mean arc weight, which did best on the generated graphs.
+    //
+    // Writes into "distances", which must hold getVertexCount() ints, and returns
+    // the number of reached vertices. Unreached vertices hold INF.
+    template <typename G>
+    size_t deltaStepping(const G &g, int start, int *distances, ThreadPool &pool, int delta = 0)
+    {
+        const uint32_t vertexCount = g.getVertexCount();
+        const unsigned workerCount = pool.getThreadCount();
+        const size_t NO_BUCKET = SIZE_MAX;
+        // frontier entries claimed at a time, small enough to balance uneven degrees
+        const size_t chunk = 64;
+
+        struct Worker
+        {
+            // buckets[i] holds the vertices this worker moved into
+            // [i * delta, (i + 1) * delta); entries go stale when the vertex
+            // moves on to a lower bucket
+            std::vector<std::vector<int>> buckets;
+            // no bucket below this one holds entries
+            size_t firstBucket = 0;
+            size_t nextBucket = 0;
+            // this worker's share of the bucket being relaxed
+            std::vector<int> frontier;
+            // vertices of the current bucket whose heavy arcs are still due
+            std::vector<int> settled;
+            std::vector<size_t> frontierOffsets;
+            uint64_t weightSum = 0;
+            uint64_t arcCount = 0;
+            size_t reached = 0;
+        };
+        std::vector<Worker> workers(workerCount);
+
+        std::vector<std::atomic<int>> tentative(vertexCount);
+        // distance at which a vertex last relaxed its light arcs, so one queued
+        // several times at the same distance relaxes them once; -1 before that
+        std::vector<std::atomic<int>> relaxedAt(vertexCount);
+
+        std::atomic<size_t> claimed{0};
+        SpinBarrier barrier(workerCount);
+
+        pool.run([&](unsigned workerIndex)
+        {
+            Worker &self = workers[workerIndex];
+            const uint32_t begin = static_cast<uint64_t>(vertexCount) * workerIndex / workerCount;
+            const uint32_t end = static_cast<uint64_t>(vertexCount) * (workerIndex + 1) / workerCount;
+
+            for (uint32_t v = begin; v < end; v++)
+            {
+                tentative[v].store(INF, std::memory_order_relaxed);
+                relaxedAt[v].store(-1, std::memory_order_relaxed);
+                if (delta <= 0)
+                {
+                    g.forEachNeighbor(v, [&](int, int weight)
+                    {
+                        self.weightSum += weight;
+                        self.arcCount++;
+                    });
+                }
+            }
+            barrier.wait();
+
+            if (workerIndex == 0)
+            {
+                if (delta <= 0)
+                {
+                    uint64_t weightSum = 0, arcCount = 0;
+                    for (const Worker &worker : workers)
+                    {
+                        weightSum += worker.weightSum;
+                        arcCount += worker.arcCount;
+                    }
+                    delta = arcCount == 0 ? 1 : std::max<uint64_t>(1, 4 * weightSum / arcCount);
+                }
+
+                tentative[start].store(0);
+                self.buckets.resize(1);
+                self.buckets[0].push_back(start);
+            }
+            barrier.wait();
+
+            auto relax = [&](int vertex, int distance)
+            {
+                int old = tentative[vertex].load(std::memory_order_relaxed);
+                while (distance < old)
+                {
+                    if (tentative[vertex].compare_exchange_weak(old, distance, std::memory_order_relaxed))
+                    {
+                        const size_t bucket = distance / delta;
+                        if (bucket >= self.buckets.size())
+                            self.buckets.resize(bucket + 1);
+                        self.buckets[bucket].push_back(vertex);
+                        self.firstBucket = std::min(self.firstBucket, bucket);
+                        return;
+                    }
+                }
+            };
+
+            size_t current = 0;
+            while (true)
+            {
+                // every worker offers its lowest non-empty bucket and all of them
+                // continue with the lowest offer
+                while (self.firstBucket < self.buckets.size() && self.buckets[self.firstBucket].empty())
+                {
+                    self.firstBucket++;
+                }
+                self.nextBucket = self.firstBucket < self.buckets.size() ? self.firstBucket : NO_BUCKET;
+                barrier.wait();
+
+                current = NO_BUCKET;
+                for (const Worker &worker : workers)
+                {
+                    current = std::min(current, worker.nextBucket);
+                }
+                if (current == NO_BUCKET)
+                    break;
+
+                // light phases, until no worker adds to the bucket any more
+                while (true)
+                {
+                    self.frontier.clear();
+                    if (current < self.buckets.size())
+                        self.frontier.swap(self.buckets[current]);
+                    if (workerIndex == 0)
+                        claimed.store(0);
+                    barrier.wait();
+
+                    // the frontier is the concatenation of the workers' shares
+                    self.frontierOffsets.assign(1, 0);
+                    for (const Worker &worker : workers)
+                    {
+                        self.frontierOffsets.push_back(self.frontierOffsets.back() + worker.frontier.size());
+                    }
+                    const size_t frontierSize = self.frontierOffsets.back();
+                    if (frontierSize == 0)
+                        break;
+
+                    size_t first;
+                    while ((first = claimed.fetch_add(chunk)) < frontierSize)
+                    {
+                        const size_t last = std::min(first + chunk, frontierSize);
+                        unsigned part = 0;
+                        for (size_t i = first; i < last; i++)
+                        {
+                            while (self.frontierOffsets[part + 1] <= i)
+                            {
+                                part++;
+                            }
+                            const int vertex = workers[part].frontier[i - self.frontierOffsets[part]];
+                            const int distance = tentative[vertex].load(std::memory_order_relaxed);
+
+                            // stale, or already relaxed at this distance
+                            if (static_cast<size_t>(distance / delta) != current)
+                                continue;
+                            const int previous = relaxedAt[vertex].exchange(distance);
+                            if (previous == distance)
+                                continue;
+                            if (previous == -1)
+                                self.settled.push_back(vertex);
+
+                            g.forEachNeighbor(vertex, [&](int neighbor, int weight)
+                            {
+                                if (weight <= delta)
+                                    relax(neighbor, distance + weight);
+                            });
+                        }
+                    }
+                    barrier.wait();
+                }
+
+                // the bucket is final, heavy arcs only reach later buckets
+                for (int vertex : self.settled)
+                {
+                    const int distance = tentative[vertex].load(std::memory_order_relaxed);
+                    g.forEachNeighbor(vertex, [&](int neighbor, int weight)
+                    {
+                        if (weight > delta)
+                            relax(neighbor, distance + weight);
+                    });
+                }
+                self.settled.clear();
+            }
+
+            for (uint32_t v = begin; v < end; v++)
+            {
+                distances[v] = tentative[v].load(std::memory_order_relaxed);
+                if (distances[v] != INF)
+                    self.reached++;
+            }
+        });
+
+        size_t reached = 0;
+        for (const Worker &worker : workers)
+        {
+            reached += worker.reached;
+        }
+        return reached;
+    }
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "search.h"
+#include "simd_kernels.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Scratch state of denseAStarSearch and denseDjikstra. Scores live in plain
+// arrays so the simd kernels can relax a whole matrix row at once; resetting
+// costs O(V), which is nothing next to the O(V) row scan of every settled
+// vertex, and a reused workspace does not allocate.
+template <typename OpenSet = BinaryHeap>
+struct DenseWorkspace
+{
+    OpenSet openSet;
+    std::vector<int> gScore;
+    std::vector<int> cameFrom;
+    // columns improved by the last row relaxation
+    std::vector<uint32_t> improved;
+    // denseDjikstra's distances of the vertices still open, INF once settled
+    std::vector<int> keys;
+    // vertices of the last path found, start first
+    std::vector<int> path;
+    // vertices taken off the open set by the last query
+    size_t settled = 0;
+    // operation counts of the last query, see search_stats.h
+    SearchStats stats;
+    // when set, the last query's settled vertices in settling order
+    // (only recorded with ASTAR_ENABLE_STATS)
+    std::vector<int> *trace = nullptr;
+
+    void reset(size_t vertexCount)
+    {
+        gScore.assign(vertexCount, search::INF);
+        cameFrom.assign(vertexCount, -1);
+        improved.resize(vertexCount);
+        openSet.reserve(vertexCount);
+        openSet.clear();
+        path.clear();
+        settled = 0;
+        ASTAR_STATS(stats.clear());
+        ASTAR_STATS(if (trace) trace->clear());
+    }
+
+    // starts a denseDjikstra run, which keys the vertices in "keys" instead
+    // of the open set
+    void resetKeys(size_t vertexCount)
+    {
+        keys.assign(vertexCount, search::INF);
+        cameFrom.resize(vertexCount);
+        improved.resize(vertexCount);
+        settled = 0;
+        ASTAR_STATS(stats.clear());
+        ASTAR_STATS(if (trace) trace->clear());
+    }
+
+    // the row relaxation looks at every column, count the actual edges
+    // among them like the edge by edge searches do
+    void countRelaxed(const int *row, size_t vertexCount)
+    {
+        ASTAR_STATS(stats.relaxed += std::count_if(row, row + vertexCount, [](int weight)
+        {
+            return weight != 0;
+        }));
+    }
+};
+
+// Searches for adjacency matrix graphs. Besides the usual graph interface the
+// graph provides
+//   const int *getRow(int vertex) const;  // getVertexCount() weights, 0 for no edge
+// and the searches relax that row with simd::relaxRow instead of visiting the
+// edges one by one.
+namespace search
+{
+    // Dijkstra with the array scan instead of a heap, O(V^2) but branch-free
+    // and vectorized, which beats a heap once most vertex pairs are connected.
+    // Same contract as djikstra in search.h; the scratch arrays come from
+    // "workspace".
+    template <typename OpenSet, typename G>
+    size_t denseDjikstra(const G &g, int start, int *distances, DenseWorkspace<OpenSet> &workspace,
+                         const DijkstraLimits &limits = {})
+    {
+        const uint32_t vertexCount = g.getVertexCount();
+
+        std::fill(distances, distances + vertexCount, INF);
+        workspace.resetKeys(vertexCount);
+        std::vector<int> &keys = workspace.keys;
+
+        size_t remainingTargets = limits.targetCount;
+        // vertices with a finite key, the dense stand-in for the open set size
+        ASTAR_STATS(size_t openCount = 1);
+
+        distances[start] = 0;
+        keys[start] = 0;
+        ASTAR_STATS(workspace.stats.pushes++);
+        ASTAR_STATS(workspace.stats.peakOpenSetSize = 1);
+
+        while (true)
+        {
+            int closestVertex = simd::argmin(keys.data(), vertexCount);
+            if (closestVertex == -1 || keys[closestVertex] > limits.maxDistance)
+                break;
+
+            keys[closestVertex] = INF;
+            workspace.settled++;
+            ASTAR_STATS(workspace.stats.pops++);
+            ASTAR_STATS(openCount--);
+            ASTAR_STATS(if (workspace.trace) workspace.trace->push_back(closestVertex));
+
+            for (size_t i = 0; i < limits.targetCount; i++)
+            {
+                if (limits.targets[i] == closestVertex)
+                    remainingTargets--;
+            }
+            if (limits.targetCount != 0 && remainingTargets == 0)
+                break;
+
+            // settled vertices are never improved again, so their keys stay INF
+            const int *row = g.getRow(closestVertex);
+            workspace.countRelaxed(row, vertexCount);
+            size_t count = simd::relaxRow(row, vertexCount, distances[closestVertex], closestVertex, distances,
+                                          workspace.cameFrom.data(), workspace.improved.data());
+            for (size_t i = 0; i < count; i++)
+            {
+                const uint32_t vertex = workspace.improved[i];
+                ASTAR_STATS(keys[vertex] == INF ? (workspace.stats.pushes++, openCount++)
+                                                : workspace.stats.decreaseKeys++);
+                keys[vertex] = distances[vertex];
+            }
+            ASTAR_STATS(workspace.stats.peakOpenSetSize = std::max(workspace.stats.peakOpenSetSize, openCount));
+        }
+
+        return workspace.settled;
+    }
+
+    // same with a workspace kept per thread, so repeated calls do not allocate
+    template <typename G>
+    size_t denseDjikstra(const G &g, int start, int *distances, const DijkstraLimits &limits = {})
+    {
+        static thread_local DenseWorkspace<> workspace;
+        return denseDjikstra(g, start, distances, workspace, limits);
+    }
+
+    // A* that relaxes the whole row of every settled vertex with one kernel
+    // call and only pushes the improved columns. Same contract as aStarSearch
+    // in search.h.
+    template <typename OpenSet, typename G, typename H>
+    bool denseAStarSearch(const G &g, int start, int finish, const H &heuristic, DenseWorkspace<OpenSet> &workspace)
+    {
+        const uint32_t vertexCount = g.getVertexCount();
+        workspace.reset(vertexCount);
+        OpenSet &openSet = workspace.openSet;
+
+        workspace.gScore[start] = 0;
+        openSet.push(start, heuristic(start));
+        ASTAR_STATS(workspace.stats.pushes++);
+        ASTAR_STATS(workspace.stats.heuristicEvaluations++);
+        ASTAR_STATS(workspace.stats.peakOpenSetSize = 1);
+
+        while (!openSet.empty())
+        {
+            int currentVertex = openSet.pop();
+            workspace.settled++;
+            ASTAR_STATS(workspace.stats.pops++);
+            ASTAR_STATS(if (workspace.trace) workspace.trace->push_back(currentVertex));
+
+            if (currentVertex == finish)
+            {
+                workspace.path.clear();
+                for (int vertex = finish; vertex != -1; vertex = workspace.cameFrom[vertex])
+                {
+                    workspace.path.push_back(vertex);
+                }
+                std::reverse(workspace.path.begin(), workspace.path.end());
+                return true;
+            }
+
+            const int *row = g.getRow(currentVertex);
+            workspace.countRelaxed(row, vertexCount);
+            size_t count = simd::relaxRow(row, vertexCount, workspace.gScore[currentVertex], currentVertex,
+                                          workspace.gScore.data(), workspace.cameFrom.data(),
+                                          workspace.improved.data());
+            for (size_t i = 0; i < count; i++)
+            {
+                int neighbor = workspace.improved[i];
+                ASTAR_STATS(openSet.contains(neighbor) ? workspace.stats.decreaseKeys++ : workspace.stats.pushes++);
+                openSet.push(neighbor, workspace.gScore[neighbor] + heuristic(neighbor));
+                ASTAR_STATS(workspace.stats.heuristicEvaluations++);
+            }
+            ASTAR_STATS(workspace.stats.peakOpenSetSize = std::max(workspace.stats.peakOpenSetSize, openSet.size()));
+        }
+
+        return false;
+    }
+
+    // selects the heuristic policy for "mode" once per query
+    template <typename OpenSet, typename G>
+    bool denseAStarSearch(const G &g, int start, int finish, HeuristicModes mode, DenseWorkspace<OpenSet> &workspace)
+    {
+        return dispatchHeuristic(mode, [&](auto metric)
+        {
+            return denseAStarSearch(g, start, finish, makePointHeuristic(g, metric, finish), workspace);
+        });
+    }
+}
@@ -0,0 +1,389 @@
+#pragma once
+
+#include "geometry.h"
+#include "heap.h"
+#include "heuristics.h"
+#include "search.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// weight of an ArcChange that deletes the arc
+const int ARC_REMOVED = -1;
+
+// g and rhs of a vertex without a path to the finish; far from overflowing
+// when a weight is added
+const int64_t DSTAR_UNREACHED = std::numeric_limits<int64_t>::max() / 4;
+
+// New weight of the arc from -> to: inserts the arc when it does not exist,
+// deletes it when the weight is ARC_REMOVED. Add both directions for an
+// undirected edge.
+struct ArcChange
+{
+    uint32_t from;
+    uint32_t to;
+    int weight;
+};
+
+// D* Lite incremental planner.
+//
+// The planner keeps its own mutable copy of the graph and searches backwards
+// from the finish, keeping g (the settled distance to the finish) and rhs (the
+// one-step lookahead) for every vertex between calls. After a batch of arc
+// changes only the vertices whose g and rhs disagree are put back on the open
+// set, so a repair re-expands the part of the search the changes actually
+// affect instead of starting over. The start may move along the path between
+// batches (moveStart), as a vehicle following the plan does.
+//
+// "Metric" is one of the heuristic policies from heuristics.h. It has to be
+// consistent: a lower bound of every arc weight, also after the changes, that
+// satisfies the triangle inequality exactly, otherwise repairs stop early and
+// leave stale distances. ChebyshevHeuristic does for coordinate-derived
+// weights; use ZeroHeuristic when weights can drop below the straight-line
+// distance.
+//
+// The planner also provides the graph interface of search.h, so a full A* on
+// the changed graph can be run for comparison.
+template <typename Metric = ChebyshevHeuristic>
+class DStarLite
+{
+private:
+    struct Arc
+    {
+        uint32_t vertex;
+        int weight;
+    };
+
+    using Key = std::pair<int64_t, int64_t>;
+
+    // outgoing[v] are the arcs v -> vertex, incoming[v] the arcs vertex -> v
+    std::vector<std::vector<Arc>> outgoing;
+    std::vector<std::vector<Arc>> incoming;
+    std::vector<char> vertexNames;
+    std::vector<Point> coordinates;
+    size_t arcCount = 0;
+    Metric metric;
+
+    std::vector<int64_t> g;
+    std::vector<int64_t> rhs;
+    DaryHeap<2, Key> openSet;
+    int start = -1;
+    int finish = -1;
+    // start at the last repair, the heuristic offset km grows as the start moves
+    int lastStart = -1;
+    int64_t keyModifier = 0;
+
+    size_t lastExpansions = 0;
+    size_t totalExpansions = 0;
+    std::vector<int> path;
+
+    int64_t heuristic(int vertex) const
+    {
+        return metric(coordinates[start], coordinates[vertex]);
+    }
+
+    Key calculateKey(int vertex) const
+    {
+        int64_t best = std::min(g[vertex], rhs[vertex]);
+        return {best + heuristic(vertex) + keyModifier, best};
+    }
+
+    // sets "arcs" entry for "vertex", returns the old weight or ARC_REMOVED
+    static int setArc(std::vector<Arc> &arcs, uint32_t vertex, int weight)
+    {
+        for (size_t i = 0; i < arcs.size(); i++)
+        {
+            if (arcs[i].vertex != vertex)
+                continue;
+
+            int old = arcs[i].weight;
+            if (weight == ARC_REMOVED)
+            {
+                arcs[i] = arcs.back();
+                arcs.pop_back();
+            }
+            else
+            {
+                arcs[i].weight = weight;
+            }
+            return old;
+        }
+
+        if (weight != ARC_REMOVED)
+            arcs.push_back({vertex, weight});
+        return ARC_REMOVED;
+    }
+
+    // min over the arcs vertex -> s of weight + g(s)
+    int64_t lookahead(int vertex) const
+    {
+        int64_t best = DSTAR_UNREACHED;
+        for (const Arc &arc : outgoing[vertex])
+        {
+            best = std::min(best, arc.weight + g[arc.vertex]);
+        }
+        return std::min(best, DSTAR_UNREACHED);
+    }
+
+    void updateVertex(int vertex)
+    {
+        if (g[vertex] != rhs[vertex])
+            openSet.update(vertex, calculateKey(vertex));
+        else
+            openSet.remove(vertex);
+    }
+
+    void computeShortestPath()
+    {
+        lastExpansions = 0;
+
+        while (!openSet.empty() && (openSet.topKey() < calculateKey(start) || rhs[start] != g[start]))
+        {
+            Key oldKey = openSet.topKey();
+            int vertex = openSet.pop();
+
+            // queued before the start moved, the key has grown since
+            Key newKey = calculateKey(vertex);
+            if (oldKey < newKey)
+            {
+                openSet.update(vertex, newKey);
+                continue;
+            }
+
+            lastExpansions++;
+            if (g[vertex] > rhs[vertex])
+            {
+                // overconsistent: the vertex got closer, settle it
+                g[vertex] = rhs[vertex];
+                for (const Arc &arc : incoming[vertex])
+                {
+                    if (arc.vertex == static_cast<uint32_t>(finish))
+                        continue;
+                    rhs[arc.vertex] = std::min(rhs[arc.vertex], arc.weight + g[vertex]);
+                    updateVertex(arc.vertex);
+                }
+            }
+            else
+            {
+                // underconsistent: the vertex got farther, invalidate it and
+                // the predecessors whose lookahead went through it
+                int64_t oldG = g[vertex];
+                g[vertex] = DSTAR_UNREACHED;
+
+                for (const Arc &arc : incoming[vertex])
+                {
+                    if (arc.vertex != static_cast<uint32_t>(finish) && rhs[arc.vertex] == arc.weight + oldG)
+                        rhs[arc.vertex] = lookahead(arc.vertex);
+                    updateVertex(arc.vertex);
+                }
+                updateVertex(vertex);
+            }
+        }
+
+        totalExpansions += lastExpansions;
+    }
+
+public:
+    // copies "g", any graph type with the interface from search.h
+    template <typename G>
+    explicit DStarLite(const G &g, Metric metric = Metric());
+
+    uint32_t getVertexCount() const
+    {
+        return outgoing.size();
+    }
+
+    size_t getEdgeCount() const
+    {
+        return arcCount;
+    }
+
+    char getVertexName(int vertex) const
+    {
+        return vertexNames[vertex];
+    }
+
+    const Point &getCoordinate(int vertex) const
+    {
+        return coordinates[vertex];
+    }
+
+    // calls f(neighbor, weight) for every arc leaving "vertex" in the changed graph
+    template <typename F>
+    void forEachNeighbor(int vertex, F f) const
+    {
+        for (const Arc &arc : outgoing[vertex])
+        {
+            f(arc.vertex, arc.weight);
+        }
+    }
+
+    // Plans from scratch, forgetting any earlier search. Returns the distance,
+    // search::INF when "finish" is unreachable.
+    int plan(int start, int finish);
+
+    // Moves the start to "vertex", usually the next vertex of the path. The
+    // search state is kept; the next repair accounts for the move.
+    void moveStart(int vertex);
+
+    // Applies the changes to the graph and repairs the plan. Returns the new
+    // distance, search::INF when the finish became unreachable. Without a plan
+    // only the graph is changed.
+    int applyChanges(const std::vector<ArcChange> &changes);
+
+    int getDistance() const
+    {
+        return start == -1 || g[start] >= DSTAR_UNREACHED ? search::INF : static_cast<int>(g[start]);
+    }
+
+    // current path from the start to the finish, empty when there is none
+    const std::vector<int> &getPath();
+
+    // vertices expanded by the last plan or repair
+    size_t getLastExpansions() const
+    {
+        return lastExpansions;
+    }
+
+    // vertices expanded since the planner was created
+    size_t getTotalExpansions() const
+    {
+        return totalExpansions;
+    }
+};
+
+template <typename Metric>
+template <typename G>
+DStarLite<Metric>::DStarLite(const G &graph, Metric metric)
+    : outgoing(graph.getVertexCount()), incoming(graph.getVertexCount()), metric(metric)
+{
+    const uint32_t vertexCount = graph.getVertexCount();
+    vertexNames.reserve(vertexCount);
+    coordinates.reserve(vertexCount);
+
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        vertexNames.push_back(graph.getVertexName(i));
+        coordinates.push_back(graph.getCoordinate(i));
+        graph.forEachNeighbor(i, [&](int neighbor, int weight)
+        {
+            outgoing[i].push_back({static_cast<uint32_t>(neighbor), weight});
+            incoming[neighbor].push_back({i, weight});
+            arcCount++;
+        });
+    }
+
+    g.assign(vertexCount, DSTAR_UNREACHED);
+    rhs.assign(vertexCount, DSTAR_UNREACHED);
+    openSet.reserve(vertexCount);
+}
+
+template <typename Metric>
+int DStarLite<Metric>::plan(int start, int finish)
+{
+    this->start = start;
+    this->finish = finish;
+    lastStart = start;
+    keyModifier = 0;
+    path.clear();
+
+    std::fill(g.begin(), g.end(), DSTAR_UNREACHED);
+    std::fill(rhs.begin(), rhs.end(), DSTAR_UNREACHED);
+    openSet.clear();
+
+    rhs[finish] = 0;
+    openSet.update(finish, calculateKey(finish));
+    computeShortestPath();
+
+    return getDistance();
+}
+
+template <typename Metric>
+void DStarLite<Metric>::moveStart(int vertex)
+{
+    start = vertex;
+    path.clear();
+}
+
+template <typename Metric>
+int DStarLite<Metric>::applyChanges(const std::vector<ArcChange> &changes)
+{
+    path.clear();
+
+    if (start != -1)
+    {
+        // the keys already queued were computed from the old start
+        keyModifier += metric(coordinates[lastStart], coordinates[start]);
+        lastStart = start;
+    }
+
+    for (const ArcChange &change : changes)
+    {
+        if (change.from >= getVertexCount() || change.to >= getVertexCount() || change.from == change.to)
+            continue;
+
+        int oldWeight = setArc(outgoing[change.from], change.to, change.weight);
+        setArc(incoming[change.to], change.from, change.weight);
+        if (oldWeight == ARC_REMOVED && change.weight != ARC_REMOVED)
+            arcCount++;
+        else if (oldWeight != ARC_REMOVED && change.weight == ARC_REMOVED)
+            arcCount--;
+
+        if (start == -1 || change.from == static_cast<uint32_t>(finish))
+            continue;
+
+        const int64_t oldCost = oldWeight == ARC_REMOVED ? DSTAR_UNREACHED : oldWeight + g[change.to];
+        const int64_t newCost = change.weight == ARC_REMOVED ? DSTAR_UNREACHED : change.weight + g[change.to];
+        int64_t &lookaheadOfFrom = rhs[change.from];
+
+        if (newCost < oldCost)
+            lookaheadOfFrom = std::min(lookaheadOfFrom, newCost);
+        else if (newCost > oldCost && lookaheadOfFrom == oldCost)
+            lookaheadOfFrom = lookahead(change.from);
+        updateVertex(change.from);
+    }
+
+    if (start == -1)
+        return search::INF;
+
+    computeShortestPath();
+    return getDistance();
+}
+
+template <typename Metric>
+const std::vector<int> &DStarLite<Metric>::getPath()
+{
+    if (!path.empty() || getDistance() == search::INF)
+        return path;
+
+    // follow the cheapest arc towards the finish; g is consistent along it
+    int vertex = start;
+    path.push_back(vertex);
+    while (vertex != finish && path.size() <= getVertexCount())
+    {
+        int next = -1;
+        int64_t best = DSTAR_UNREACHED;
+        for (const Arc &arc : outgoing[vertex])
+        {
+            if (arc.weight + g[arc.vertex] < best)
+            {
+                best = arc.weight + g[arc.vertex];
+                next = arc.vertex;
+            }
+        }
+        if (next == -1)
+        {
+            path.clear();
+            return path;
+        }
+        vertex = next;
+        path.push_back(vertex);
+    }
+
+    // the walk circled, e.g. along zero-weight ties, without reaching the finish
+    if (vertex != finish)
+        path.clear();
+    return path;
+}
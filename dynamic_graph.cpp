@@ -0,0 +1,233 @@
+#include "dynamic_graph.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+HeuristicModes DynamicGraph::heuristicMode = HeuristicModes::euclidean;
+
+void DynamicGraph::setHeuristic(HeuristicModes heuristic)
+{
+    heuristicMode = heuristic;
+}
+
+void DynamicGraph::reserve(size_t vertexCount)
+{
+    adjacency.reserve(vertexCount);
+    vertexNames.reserve(vertexCount);
+    coordinates.reserve(vertexCount);
+    components.reserve(vertexCount);
+}
+
+char DynamicGraph::getVertexName(int vertex) const
+{
+    return vertexNames[vertex];
+}
+
+uint32_t DynamicGraph::getVertexCount() const
+{
+    return coordinates.size();
+}
+
+size_t DynamicGraph::getEdgeCount() const
+{
+    return arcCount;
+}
+
+const Point &DynamicGraph::getCoordinate(int vertex) const
+{
+    return coordinates[vertex];
+}
+
+const SpatialIndex &DynamicGraph::getSpatialIndex() const
+{
+    return spatialIndex;
+}
+
+const ComponentIndex &DynamicGraph::getComponents() const
+{
+    return components;
+}
+
+uint32_t DynamicGraph::addVertex(char name, const Point &coordinate)
+{
+    vertexNames.push_back(name);
+    coordinates.push_back(coordinate);
+    adjacency.emplace_back();
+    spatialIndex.insert(coordinates.size() - 1, coordinate);
+    components.addVertex();
+    return coordinates.size() - 1;
+}
+
+bool DynamicGraph::setArc(uint32_t from, uint32_t to, int weight)
+{
+    for (Edge &edge : adjacency[from])
+    {
+        if (edge.to == to)
+        {
+            edge.weight = weight;
+            return false;
+        }
+    }
+
+    adjacency[from].push_back({to, weight});
+    arcCount++;
+    return true;
+}
+
+void DynamicGraph::addEdge(uint32_t i, uint32_t j)
+{
+    if (i >= getVertexCount() || j >= getVertexCount())
+        return;
+
+    addEdge(i, j, getDistance(coordinates[i], coordinates[j]));
+}
+
+void DynamicGraph::addEdge(uint32_t i, uint32_t j, int weight)
+{
+    if (i >= getVertexCount() || j >= getVertexCount())
+        return;
+
+    if (i == j)
+        return;
+
+    setArc(i, j, weight);
+    setArc(j, i, weight);
+    components.connect(i, j);
+}
+
+void DynamicGraph::addArc(uint32_t from, uint32_t to, int weight)
+{
+    if (from >= getVertexCount() || to >= getVertexCount())
+        return;
+
+    if (from == to)
+        return;
+
+    setArc(from, to, weight);
+    components.connect(from, to);
+    hasOneWayArcs = true;
+}
+
+void DynamicGraph::print() const
+{
+    for (uint32_t i = 0; i < getVertexCount(); i++)
+    {
+        std::cout << vertexNames[i] << ":";
+        for (const Edge &edge : adjacency[i])
+        {
+            std::cout << " " << vertexNames[edge.to] << "(" << edge.weight << ")";
+        }
+        std::cout << "\n";
+    }
+}
+
+int DynamicGraph::getNearbyVertex(const Point &pos) const
+{
+    return spatialIndex.nearest(pos, SNAP_DISTANCE);
+}
+
+std::vector<int> DynamicGraph::depthFirstSearch(int start) const
+{
+    return search::depthFirstOrder(*this, start);
+}
+
+std::vector<int> DynamicGraph::breathFirstSearch(int start) const
+{
+    return search::breadthFirstOrder(*this, start);
+}
+
+bool DynamicGraph::isConnected() const
+{
+    // one-way arcs can join components that are not mutually reachable
+    if (hasOneWayArcs)
+        return search::isConnected(*this);
+
+    return components.getComponentCount() <= 1;
+}
+
+std::vector<int> DynamicGraph::djikstra(int start) const
+{
+    return search::djikstra(*this, start);
+}
+
+size_t DynamicGraph::djikstra(int start, int *distances, const search::DijkstraLimits &limits) const
+{
+    return search::djikstra(*this, start, distances, limits);
+}
+
+int DynamicGraph::heuristic(int current, int finish) const
+{
+    return search::heuristic(*this, heuristicMode, current, finish);
+}
+
+DynamicGraph DynamicGraph::getRandomGraph(size_t vertexCount, int density, int width, int height)
+{
+    // vertices keep at least "spacing" pixels apart on one of the axes, so at
+    // most one fits in every spacing x spacing square
+    const int spacing = 5;
+    // consecutive rejected positions before the area counts as full
+    const int maxAttempts = 1000;
+
+    if (width <= 0 || height <= 0)
+        throw std::invalid_argument("Graph area must not be empty");
+    const size_t capacity = static_cast<size_t>((width + spacing - 1) / spacing) * ((height + spacing - 1) / spacing);
+    if (vertexCount > capacity)
+        throw std::invalid_argument("A " + std::to_string(width) + "x" + std::to_string(height) +
+                                    " area cannot hold " + std::to_string(vertexCount) + " vertices");
+
+    DynamicGraph g;
+    g.reserve(vertexCount);
+    char letter = 'A';
+    std::vector<uint32_t> close;
+
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        Point pos;
+
+        bool goodPos = false;
+
+        for (int attempt = 0; !goodPos; attempt++)
+        {
+            if (attempt == maxAttempts)
+                throw std::runtime_error("No free position left for vertex " + std::to_string(i) + " of " +
+                                         std::to_string(vertexCount));
+
+            goodPos = true;
+            pos.x = rand() % width;
+            pos.y = rand() % height;
+
+            // everything closer than spacing on both axes lies within this radius
+            g.spatialIndex.withinRadius(pos, spacing * 3 / 2, close);
+            for (uint32_t j : close)
+            {
+                int xDif = std::abs(g.coordinates[j].x - pos.x);
+                int yDif = std::abs(g.coordinates[j].y - pos.y);
+                if (xDif < spacing && yDif < spacing)
+                {
+                    goodPos = false;
+                    break;
+                }
+            }
+        }
+        g.addVertex(letter, pos);
+
+        letter++;
+    }
+
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        for (size_t j = 0; j < vertexCount; j++)
+        {
+            if (i == j)
+                continue;
+            uint8_t choice = rand() % 100;
+
+            if (choice > 100 - density)
+            {
+                g.addEdge(i, j);
+            }
+        }
+    }
+
+    return g;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "components.h"
+#include "geometry.h"
+#include "search.h"
+#include "spatial_index.h"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Weighted graph sized at runtime, undirected unless one-way arcs are added
+// with addArc.
+//
+// Vertices and edges are appended with addVertex/addEdge and storage grows with
+// amortized reallocation, so the graph can hold millions of vertices. Each
+// vertex keeps its own adjacency list, so neighbor expansion is O(degree).
+// Graph<N> remains the fixed-capacity variant for tiny dense graphs.
+class DynamicGraph
+{
+public:
+    struct Edge
+    {
+        uint32_t to;
+        int weight;
+    };
+
+private:
+    std::vector<std::vector<Edge>> adjacency;
+    std::vector<char> vertexNames;
+    std::vector<Point> coordinates;
+    size_t arcCount = 0;
+    SpatialIndex spatialIndex;
+    // kept up to date by addVertex/addEdge/addArc
+    ComponentIndex components;
+    bool hasOneWayArcs = false;
+    static HeuristicModes heuristicMode;
+
+    // adds the arc or updates its weight, returns true when it is new
+    bool setArc(uint32_t from, uint32_t to, int weight);
+
+public:
+    static void setHeuristic(HeuristicModes);
+
+    // preallocates storage for "vertexCount" vertices
+    void reserve(size_t vertexCount);
+
+    char getVertexName(int vertex) const;
+
+    uint32_t getVertexCount() const;
+
+    // number of arcs, an undirected edge counts twice like in CsrGraph
+    size_t getEdgeCount() const;
+
+    const Point &getCoordinate(int vertex) const;
+
+    // kept up to date by addVertex
+    const SpatialIndex &getSpatialIndex() const;
+
+    // connected components, weakly connected ones once addArc was used
+    const ComponentIndex &getComponents() const;
+
+    // calls f(neighbor, weight) for every edge leaving "vertex"
+    template <typename F>
+    void forEachNeighbor(int vertex, F f) const;
+
+    // returns the id of the new vertex
+    uint32_t addVertex(char name, const Point &coordinate);
+
+    // adds or updates the edge, its weight is the distance between the vertices
+    void addEdge(uint32_t i, uint32_t j);
+
+    // adds or updates the edge with an explicit weight
+    void addEdge(uint32_t i, uint32_t j, int weight);
+
+    // adds or updates the one-way arc from -> to
+    void addArc(uint32_t from, uint32_t to, int weight);
+
+    void print() const;
+
+    // closest vertex within SNAP_DISTANCE of "pos", -1 if there is none
+    int getNearbyVertex(const Point &pos) const;
+
+    // vertices reachable from "start", in depth-first discovery order
+    std::vector<int> depthFirstSearch(int start) const;
+
+    // vertices reachable from "start", in breadth-first order
+    std::vector<int> breathFirstSearch(int start) const;
+
+    // O(1) from the component index, unless one-way arcs make it a search
+    bool isConnected() const;
+
+    std::vector<int> djikstra(int start) const;
+
+    size_t djikstra(int start, int *distances, const search::DijkstraLimits &limits = {}) const;
+
+    int heuristic(int current, int finish) const;
+
+    template <typename OpenSet = BinaryHeap>
+    std::vector<int> aStarSearch(int start, int finish) const;
+
+    // Allocation-free variant, the path is left in workspace.path. Both variants
+    // reject vertices of different components without searching.
+    template <typename OpenSet>
+    bool aStarSearch(int start, int finish, SearchWorkspace<OpenSet> &workspace) const;
+
+    // "vertexCount" vertices scattered over a width x height area, each pair
+    // connected with a probability of "density" percent. Throws when the area
+    // cannot fit that many vertices 5 pixels apart.
+    static DynamicGraph getRandomGraph(size_t vertexCount, int density, int width, int height);
+};
+
+template <typename OpenSet>
+std::vector<int> DynamicGraph::aStarSearch(int start, int finish) const
+{
+    if (!components.isConnected(start, finish))
+        throw std::logic_error("Not path found");
+
+    return search::aStarSearch<OpenSet>(*this, start, finish, heuristicMode);
+}
+
+template <typename OpenSet>
+bool DynamicGraph::aStarSearch(int start, int finish, SearchWorkspace<OpenSet> &workspace) const
+{
+    if (!components.isConnected(start, finish))
+    {
+        workspace.reset(getVertexCount());
+        return false;
+    }
+
+    return search::aStarSearch(*this, start, finish, heuristicMode, workspace);
+}
+
+template <typename F>
+void DynamicGraph::forEachNeighbor(int vertex, F f) const
+{
+    for (const Edge &edge : adjacency[vertex])
+    {
+        f(edge.to, edge.weight);
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cmath>
+#include <cstdlib>
+
+struct Point
+{
+    int x, y;
+};
+
+struct Line
+{
+    Point begin;
+    Point end;
+};
+
+inline int getDistance(const Point &p1, const Point &p2)
+{
+    double a = std::abs(p1.x - p2.x);
+    a *= a;
+
+    double b = std::abs(p1.y - p2.y);
+    b *= b;
+
+    int c = std::sqrt(a + b);
+
+    return c;
+}
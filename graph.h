@@ -1,46 +1,19 @@
-#include "helper.h"
+#pragma once
+
+#include "components.h"
+#include "dense_search.h"
+#include "geometry.h"
+#include "memory_usage.h"
+#include "spatial_index.h"
 #include <algorithm>
 #include <array>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <cstdlib>
 #include <exception>
 #include <iostream>
-#include <queue>
-#include <set>
 #include <vector>
-struct Point
-{
-    int x, y;
-};
-
-struct Line
-{
-    Point begin;
-    Point end;
-};
-
-enum class HeuristicModes
-{
-    xDifference,
-    yDifference,
-    euclidean,
-    zero,
-    last
-};
-
-int getDistance(const Point &p1, const Point &p2)
-{
-    double a = std::abs(p1.x - p2.x);
-    a *= a;
-
-    double b = std::abs(p1.y - p2.y);
-    b *= b;
-
-    int c = std::sqrt(a + b);
-
-    return c;
-}
 
 template <size_t N>
 class Graph
@@ -50,14 +23,33 @@ private:
     uint32_t vertexCount = 0;
     char vertexNames[N] = {0};
     Point coordinates[N] = {};
+    SpatialIndex spatialIndex;
+    ComponentIndex components;
     static HeuristicModes heuristicMode;
 
-    void dfsUtil(int vertex, std::array<bool, N> &visited);
-
 public:
     static void setHeuristic(HeuristicModes);
 
-    char getVertexName(int vertex);
+    char getVertexName(int vertex) const;
+
+    uint32_t getVertexCount() const;
+
+    const Point &getCoordinate(int vertex) const;
+
+    const SpatialIndex &getSpatialIndex() const;
+
+    // kept up to date by addVertex/addEdge
+    const ComponentIndex &getComponents() const;
+
+    // weights of the edges leaving "vertex", 0 where there is none
+    const int *getRow(int vertex) const;
+
+    // the whole N x N matrix counts as edge storage, whatever the vertex count
+    MemoryUsage getMemoryUsage() const;
+
+    // calls f(neighbor, weight) for every edge leaving "vertex"
+    template <typename F>
+    void forEachNeighbor(int vertex, F f) const;
 
     void addEdge(uint32_t i, uint32_t j);
 
@@ -65,27 +57,49 @@ public:
 
     void print();
 
-    void draw();
-
+    // closest vertex within SNAP_DISTANCE of "pos", -1 if there is none
     int getNearbyVertex(const Point &pos);
 
-    void depthFirstSearch(int start);
+    // vertices reachable from "start", in depth-first discovery order
+    std::vector<int> depthFirstSearch(int start) const;
 
-    void breathFirstSearch(int start);
+    // vertices reachable from "start", in breadth-first order
+    std::vector<int> breathFirstSearch(int start) const;
 
+    // O(1) from the component index
     bool isConnected();
 
     std::array<int, N> djikstra(int start);
 
+    size_t djikstra(int start, int *distances, const search::DijkstraLimits &limits = {}) const;
+
+    // same with caller-supplied scratch arrays instead of the per-thread ones
+    template <typename OpenSet>
+    size_t djikstra(int start, int *distances, DenseWorkspace<OpenSet> &workspace,
+                    const search::DijkstraLimits &limits = {}) const;
+
     int heuristic(int current, int finish);
 
     std::vector<int> reconstructPath(const std::array<int, N> &cameFrom, int end);
 
+    // the matrix searches relax whole rows with the simd kernels; all variants
+    // reject vertices of different components without searching
+    template <typename OpenSet = BinaryHeap>
     std::vector<int> aStarSearch(int start, int finish);
 
-    void drawPath(const std::vector<int> &path);
+    template <typename OpenSet>
+    bool aStarSearch(int start, int finish, DenseWorkspace<OpenSet> &workspace) const;
+
+    // generic edge by edge variant, the path is left in workspace.path
+    template <typename OpenSet>
+    bool aStarSearch(int start, int finish, SearchWorkspace<OpenSet> &workspace) const;
+
+    // replaces the graph with N random vertices scattered over a width x height
+    // area, each pair connected with a probability of "density" percent; works
+    // in place, so a graph too big for the stack can be filled on the heap
+    void randomize(int density, int width, int height);
 
-    static Graph getRandomGraph(int density);
+    static Graph getRandomGraph(int density, int width, int height);
 };
 
 template <size_t N>
@@ -98,24 +112,62 @@ template <size_t N>
 HeuristicModes Graph<N>::heuristicMode = HeuristicModes::euclidean;
 
 template <size_t N>
-void Graph<N>::dfsUtil(int vertex, std::array<bool, N> &visited)
+char Graph<N>::getVertexName(int vertex) const
 {
-    std::cout << "Visited vertex: " << vertexNames[vertex] << "\n";
-    visited[vertex] = true;
-    for (int i = 0; i < N; i++)
-    {
-        if (adjMatrix[vertex][i] != 0 && !visited[i])
-        {
-            dfsUtil(i, visited);
-        }
-    }
-    std::cout << "Backtracked to: " << vertexNames[vertex] << "\n";
+    return vertexNames[vertex];
 }
 
 template <size_t N>
-char Graph<N>::getVertexName(int vertex)
+uint32_t Graph<N>::getVertexCount() const
 {
-    return vertexNames[vertex];
+    return vertexCount;
+}
+
+template <size_t N>
+const Point &Graph<N>::getCoordinate(int vertex) const
+{
+    return coordinates[vertex];
+}
+
+template <size_t N>
+const SpatialIndex &Graph<N>::getSpatialIndex() const
+{
+    return spatialIndex;
+}
+
+template <size_t N>
+const ComponentIndex &Graph<N>::getComponents() const
+{
+    return components;
+}
+
+template <size_t N>
+const int *Graph<N>::getRow(int vertex) const
+{
+    return adjMatrix[vertex];
+}
+
+template <size_t N>
+MemoryUsage Graph<N>::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    usage.vertexBytes = sizeof(vertexNames) + sizeof(coordinates);
+    usage.edgeBytes = sizeof(adjMatrix);
+    usage.indexBytes = spatialIndex.getMemoryBytes();
+    return usage;
+}
+
+template <size_t N>
+template <typename F>
+void Graph<N>::forEachNeighbor(int vertex, F f) const
+{
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        if (adjMatrix[vertex][i] != 0)
+        {
+            f(i, adjMatrix[vertex][i]);
+        }
+    }
 }
 
 template <size_t N>
@@ -131,6 +183,7 @@ void Graph<N>::addEdge(uint32_t i, uint32_t j)
 
     adjMatrix[i][j] = distance;
     adjMatrix[j][i] = distance;
+    components.connect(i, j);
 }
 
 template <size_t N>
@@ -138,6 +191,8 @@ void Graph<N>::addVertex(char name, const Point &coordinate)
 {
     vertexNames[vertexCount] = name;
     coordinates[vertexCount] = coordinate;
+    spatialIndex.insert(vertexCount, coordinate);
+    components.addVertex();
     vertexCount++;
 }
 
@@ -162,253 +217,113 @@ void Graph<N>::print()
     }
 }
 
-template <size_t N>
-void Graph<N>::draw()
-{
-
-    for (size_t i = 0; i < vertexCount; i++)
-    {
-        helper::drawFilledCircle(coordinates[i].x, coordinates[i].y, 10);
-    }
-
-    for (size_t i = 0; i < vertexCount; i++)
-    {
-        for (size_t j = 0; j < vertexCount; j++)
-        {
-            if (adjMatrix[i][j] != 0)
-            {
-                helper::drawLine(coordinates[i].x, coordinates[i].y, coordinates[j].x, coordinates[j].y);
-            }
-        }
-    }
-}
-
 template <size_t N>
 int Graph<N>::getNearbyVertex(const Point &pos)
 {
-
-    for (size_t i = 0; i < vertexCount; i++)
-    {
-        int xDif = std::abs(coordinates[i].x - pos.x);
-        int yDif = std::abs(coordinates[i].y - pos.y);
-        if (xDif < 20 && yDif < 20)
-        {
-            return i;
-        }
-    }
-    return -1;
+    return spatialIndex.nearest(pos, SNAP_DISTANCE);
 }
 
 template <size_t N>
-void Graph<N>::depthFirstSearch(int start)
+std::vector<int> Graph<N>::depthFirstSearch(int start) const
 {
-    std::array<bool, N> visited;
-    dfsUtil(start, visited);
+    return search::depthFirstOrder(*this, start);
 }
 
 template <size_t N>
-void Graph<N>::breathFirstSearch(int start)
+std::vector<int> Graph<N>::breathFirstSearch(int start) const
 {
-    std::queue<int> q;
-    std::array<bool, N> visited;
-
-    q.push(start);
-    visited[start] = true;
-
-    while (!q.empty())
-    {
-        int currentVertex = q.front();
-        q.pop();
-
-        std::cout << "Visited vertex: " << vertexNames[currentVertex] << "\n";
-
-        for (int i = 0; i < N; i++)
-        {
-            if (adjMatrix[currentVertex][i] != 0 && !visited[i])
-            {
-                q.push(i);
-                visited[i] = true;
-            }
-        }
-    }
+    return search::breadthFirstOrder(*this, start);
 }
 
 template <size_t N>
 std::array<int, N> Graph<N>::djikstra(int start)
 {
     std::array<int, N> distances;
-    std::array<bool, N> visited;
-
-    distances[start] = 0;
+    std::fill(distances.begin() + vertexCount, distances.end(), search::INF);
 
-    std::fill(distances.begin() + 1, distances.end(), 9999999);
-    std::fill(visited.begin(), visited.end(), false);
+    djikstra(start, distances.data());
 
-    while (true)
-    {
-        // find closest unvisited vertex
-        int minDistance = 9999999;
-        int closestVertex = 0;
-        bool found = false;
-
-        for (size_t i = 0; i < vertexCount; i++)
-        {
-            if (distances[i] < minDistance && !visited[i])
-            {
-                closestVertex = i;
-                minDistance = distances[i];
-                found = true;
-            }
-        }
-        if (!found)
-            break;
-        found = false;
-
-        visited[closestVertex] = true;
+    return distances;
+}
 
-        // update distances to all unvisited adjancent vertices
-        for (size_t i = 0; i < vertexCount; i++)
-        {
-            if (adjMatrix[closestVertex][i] != 0 && !visited[i])
-            {
-                int newDistance = adjMatrix[closestVertex][i] + distances[closestVertex];
-                distances[i] = std::min(distances[i], newDistance);
-            }
-        }
-    }
+template <size_t N>
+size_t Graph<N>::djikstra(int start, int *distances, const search::DijkstraLimits &limits) const
+{
+    return search::denseDjikstra(*this, start, distances, limits);
+}
 
-    return distances;
+template <size_t N>
+template <typename OpenSet>
+size_t Graph<N>::djikstra(int start, int *distances, DenseWorkspace<OpenSet> &workspace,
+                          const search::DijkstraLimits &limits) const
+{
+    return search::denseDjikstra(*this, start, distances, workspace, limits);
 }
 
 template <size_t N>
 int Graph<N>::heuristic(int current, int finish)
 {
-    switch (heuristicMode)
-    {
-    case HeuristicModes::zero:
-        return 0;
-        break;
-    case HeuristicModes::euclidean:
-        return getDistance(coordinates[current], coordinates[finish]);
-        break;
-    case HeuristicModes::xDifference:
-        return std::abs(coordinates[current].x - coordinates[finish].x);
-        break;
-    case HeuristicModes::yDifference:
-        return std::abs(coordinates[current].y - coordinates[finish].y);
-        break;
-    default:
-        throw std::runtime_error("Incorrect heuristic");
-    }
+    return search::heuristic(*this, heuristicMode, current, finish);
 }
 
 template <size_t N>
 std::vector<int> Graph<N>::reconstructPath(const std::array<int, N> &cameFrom, int end)
 {
-    std::vector<int> path;
-
-    path.push_back(end);
-    // construct path
-    int currentVertex = cameFrom[end];
-
-    while (currentVertex != -1)
-    {
-        path.push_back(currentVertex);
-        currentVertex = cameFrom[currentVertex];
-    }
-
-    // print the path
-    std::reverse(path.begin(), path.end());
-
-    return path;
+    return search::reconstructPath(cameFrom.data(), end);
 }
 
 template <size_t N>
+template <typename OpenSet>
 std::vector<int> Graph<N>::aStarSearch(int start, int finish)
 {
+    static thread_local DenseWorkspace<OpenSet> workspace;
 
-    const int INF = 999999;
-
-    std::array<int, N> gScore, fScore, cameFrom;
-
-    std::fill(gScore.begin(), gScore.end(), INF);
-    std::fill(fScore.begin(), fScore.end(), INF);
-    std::fill(cameFrom.begin(), cameFrom.end(), -1);
-
-    std::set<int> openSet;
+    if (!aStarSearch(start, finish, workspace))
+        throw std::logic_error("Not path found");
 
-    openSet.insert(start);
-
-    gScore[start] = 0;
-    fScore[start] = heuristic(start, finish);
+    return workspace.path;
+}
 
-    while (!openSet.empty())
+template <size_t N>
+template <typename OpenSet>
+bool Graph<N>::aStarSearch(int start, int finish, DenseWorkspace<OpenSet> &workspace) const
+{
+    if (!components.isConnected(start, finish))
     {
+        workspace.reset(vertexCount);
+        return false;
+    }
 
-        // get vertex with the least fScore from openSet
-        int min = INF;
-        int currentVertex = -1;
-
-        for (int vertex : openSet)
-        {
-            if (fScore[vertex] < min)
-            {
-                min = fScore[vertex];
-                currentVertex = vertex;
-            }
-        }
-
-        openSet.erase(currentVertex);
-
-        // if it is the goal vertex
-        if (currentVertex == finish)
-        {
-            return reconstructPath(cameFrom, currentVertex);
-        }
-
-        for (size_t i = 0; i < vertexCount; i++)
-        {
-
-            // if no vertex between
-            if (adjMatrix[currentVertex][i] == 0)
-                continue;
-
-            int newGScore = gScore[currentVertex] + adjMatrix[currentVertex][i];
+    return search::denseAStarSearch(*this, start, finish, heuristicMode, workspace);
+}
 
-            // if better path is found to vertex "i"
-            if (newGScore < gScore[i])
-            {
-                gScore[i] = newGScore;
-                cameFrom[i] = currentVertex;
-                fScore[i] = gScore[i] + heuristic(i, finish);
-                openSet.insert(i);
-            }
-        }
+template <size_t N>
+template <typename OpenSet>
+bool Graph<N>::aStarSearch(int start, int finish, SearchWorkspace<OpenSet> &workspace) const
+{
+    if (!components.isConnected(start, finish))
+    {
+        workspace.reset(vertexCount);
+        return false;
     }
 
-    throw std::logic_error("Not path found");
+    return search::aStarSearch(*this, start, finish, heuristicMode, workspace);
 }
 
 template <size_t N>
 bool Graph<N>::isConnected()
 {
-    const int INF = 9999999;
-    auto distances = djikstra(0);
-
-    for (int distance : distances)
-    {
-        if (distance == INF)
-        {
-            return false;
-        }
-    }
-    return true;
+    return components.getComponentCount() <= 1;
 }
 
 template <size_t N>
-Graph<N> Graph<N>::getRandomGraph(int density)
+void Graph<N>::randomize(int density, int width, int height)
 {
-    Graph<N> g;
+    Graph<N> &g = *this;
+    std::fill(&adjMatrix[0][0], &adjMatrix[0][0] + N * N, 0);
+    vertexCount = 0;
+    spatialIndex.clear();
+    components.clear();
     char letter = 'A';
 
     for (size_t i = 0; i < N; i++)
@@ -420,14 +335,14 @@ Graph<N> Graph<N>::getRandomGraph(int density)
         while (!goodPos)
         {
             goodPos = true;
-            pos.x = rand() % helper::getWidth();
-            pos.y = rand() % helper::getHeight();
+            pos.x = rand() % width;
+            pos.y = rand() % height;
 
             for (size_t j = 0; j < i; j++)
             {
                 int xDif = std::abs(g.coordinates[j].x - pos.x);
                 int yDif = std::abs(g.coordinates[j].y - pos.y);
-                if (xDif < 5 || yDif < 5)
+                if (xDif < 5 && yDif < 5)
                 {
                     goodPos = false;
                     break;
@@ -453,27 +368,12 @@ Graph<N> Graph<N>::getRandomGraph(int density)
             }
         }
     }
-
-    return g;
 }
 
-// draws path given by "path" using vertices of this graph
 template <size_t N>
-void Graph<N>::drawPath(const std::vector<int> &path)
+Graph<N> Graph<N>::getRandomGraph(int density, int width, int height)
 {
-    if (path.empty())
-        return;
-
-    helper::setColor(0x00, 0x00, 0xFF);
-    Point current = coordinates[path[0]];
-    Point next;
-
-    for (size_t i = 1; i < path.size(); i++)
-    {
-        next = coordinates[path[i]];
-        helper::drawLine(current.x, current.y, next.x, next.y);
-        current = next;
-    }
-
-    helper::setColor(0x00, 0x00, 0xFF);
+    Graph<N> g;
+    g.randomize(density, width, height);
+    return g;
 }
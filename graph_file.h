@@ -0,0 +1,164 @@
+#pragma once
+
+#include "geometry.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Binary graph file, laid out so that a mapped file can be searched in place
+// (see MappedGraph):
+//
+//   GraphFileHeader
+//   offsets      uint64_t[vertexCount + 1]  arcs of v are [offsets[v], offsets[v + 1])
+//   neighbors    uint32_t[arcCount]
+//   weights      int32_t[arcCount]
+//   coordinates  Point[vertexCount]
+//   names        char[vertexCount]
+//
+// Every section starts at a multiple of GRAPH_FILE_ALIGNMENT and its position is
+// recorded in the header, so later versions can add sections without moving
+// the old ones. Numbers are stored in the byte order of the machine that wrote
+// the file; readers reject files written with another one.
+
+const char GRAPH_FILE_MAGIC[8] = {'A', 'S', 'T', 'A', 'R', 'G', 'R', 'F'};
+const uint32_t GRAPH_FILE_VERSION = 1;
+const uint32_t GRAPH_FILE_BYTE_ORDER = 0x01020304;
+const uint64_t GRAPH_FILE_ALIGNMENT = 64;
+
+struct GraphFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t vertexCount;
+    uint64_t arcCount;
+    // byte positions of the sections from the start of the file
+    uint64_t offsetsStart;
+    uint64_t neighborsStart;
+    uint64_t weightsStart;
+    uint64_t coordinatesStart;
+    uint64_t namesStart;
+    uint64_t fileSize;
+};
+
+static_assert(sizeof(GraphFileHeader) == 80, "GraphFileHeader must not contain padding");
+static_assert(sizeof(Point) == 8, "Point is stored as two int32_t");
+
+namespace graphfile
+{
+    inline uint64_t align(uint64_t position)
+    {
+        return (position + GRAPH_FILE_ALIGNMENT - 1) / GRAPH_FILE_ALIGNMENT * GRAPH_FILE_ALIGNMENT;
+    }
+
+    // fills in the section layout for a graph of the given size
+    inline GraphFileHeader makeHeader(uint64_t vertexCount, uint64_t arcCount)
+    {
+        GraphFileHeader header;
+        std::memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+        header.version = GRAPH_FILE_VERSION;
+        header.byteOrder = GRAPH_FILE_BYTE_ORDER;
+        header.vertexCount = vertexCount;
+        header.arcCount = arcCount;
+        header.offsetsStart = align(sizeof(GraphFileHeader));
+        header.neighborsStart = align(header.offsetsStart + (vertexCount + 1) * sizeof(uint64_t));
+        header.weightsStart = align(header.neighborsStart + arcCount * sizeof(uint32_t));
+        header.coordinatesStart = align(header.weightsStart + arcCount * sizeof(int32_t));
+        header.namesStart = align(header.coordinatesStart + vertexCount * sizeof(Point));
+        header.fileSize = header.namesStart + vertexCount;
+        return header;
+    }
+
+    // Writes any graph type (Graph<N>, DynamicGraph, CsrGraph, ...) to "path".
+    // The arcs are streamed straight from forEachNeighbor, only the offsets are
+    // kept in memory. Throws std::runtime_error when the file cannot be written.
+    template <typename G>
+    void save(const G &g, const std::string &path)
+    {
+        const uint64_t vertexCount = g.getVertexCount();
+
+        std::vector<uint64_t> offsets(vertexCount + 1, 0);
+        for (uint64_t v = 0; v < vertexCount; v++)
+        {
+            uint64_t degree = 0;
+            g.forEachNeighbor(v, [&](int, int)
+            {
+                degree++;
+            });
+            offsets[v + 1] = offsets[v] + degree;
+        }
+
+        const GraphFileHeader header = makeHeader(vertexCount, offsets[vertexCount]);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("Cannot create graph file " + path);
+
+        // many small writes, so collect them in a buffer first
+        std::vector<char> buffer;
+        uint64_t position = 0;
+        auto write = [&](const void *data, size_t size)
+        {
+            const char *bytes = static_cast<const char *>(data);
+            buffer.insert(buffer.end(), bytes, bytes + size);
+            position += size;
+            if (buffer.size() >= (1 << 20))
+            {
+                file.write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        };
+        auto pad = [&](uint64_t sectionStart)
+        {
+            static const char zeros[GRAPH_FILE_ALIGNMENT] = {};
+            write(zeros, sectionStart - position);
+        };
+
+        write(&header, sizeof(header));
+
+        pad(header.offsetsStart);
+        write(offsets.data(), offsets.size() * sizeof(uint64_t));
+
+        pad(header.neighborsStart);
+        for (uint64_t v = 0; v < vertexCount; v++)
+        {
+            g.forEachNeighbor(v, [&](int neighbor, int)
+            {
+                uint32_t value = neighbor;
+                write(&value, sizeof(value));
+            });
+        }
+
+        pad(header.weightsStart);
+        for (uint64_t v = 0; v < vertexCount; v++)
+        {
+            g.forEachNeighbor(v, [&](int, int weight)
+            {
+                int32_t value = weight;
+                write(&value, sizeof(value));
+            });
+        }
+
+        pad(header.coordinatesStart);
+        for (uint64_t v = 0; v < vertexCount; v++)
+        {
+            Point coordinate = g.getCoordinate(v);
+            write(&coordinate, sizeof(coordinate));
+        }
+
+        pad(header.namesStart);
+        for (uint64_t v = 0; v < vertexCount; v++)
+        {
+            char name = g.getVertexName(v);
+            write(&name, sizeof(name));
+        }
+
+        file.write(buffer.data(), buffer.size());
+        file.flush();
+        if (!file)
+            throw std::runtime_error("Cannot write graph file " + path);
+    }
+}
@@ -0,0 +1,317 @@
+#include "graph_generator.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace
+{
+    // the area is cut into CHUNK_COLUMNS x CHUNK_ROWS tiles, one chunk each
+    const int CHUNK_COLUMNS = 8;
+    const int CHUNK_ROWS = 8;
+    const unsigned CHUNK_COUNT = CHUNK_COLUMNS * CHUNK_ROWS;
+
+    // rejected positions in a row before a tile is considered full
+    const int MAX_FAILURES = 10000;
+
+    // hands out chunk indices to the workers of "pool" until all are done
+    template <typename F>
+    void forEachChunk(ThreadPool &pool, unsigned chunkCount, F work)
+    {
+        std::atomic<unsigned> nextChunk{0};
+        pool.run([&](unsigned)
+        {
+            for (unsigned chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++)
+            {
+                work(chunk);
+            }
+        });
+    }
+
+    // Uniform grid over the points: the points of cell c are
+    // order[cellStart[c] .. cellStart[c + 1]), with their coordinates copied
+    // next to each other so a cell scan reads contiguous memory.
+    struct PointGrid
+    {
+        int cellSize;
+        int columns;
+        int rows;
+        std::vector<uint32_t> cellStart;
+        std::vector<uint32_t> order;
+        std::vector<int> xs;
+        std::vector<int> ys;
+
+        PointGrid(const std::vector<Point> &points, int width, int height, int cellSize)
+            : cellSize(cellSize), columns(width / cellSize + 1), rows(height / cellSize + 1)
+        {
+            // counting sort of the points by cell
+            cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+            for (const Point &p : points)
+            {
+                cellStart[cellOf(p) + 1]++;
+            }
+            for (size_t i = 1; i < cellStart.size(); i++)
+            {
+                cellStart[i] += cellStart[i - 1];
+            }
+
+            order.resize(points.size());
+            xs.resize(points.size());
+            ys.resize(points.size());
+            std::vector<uint32_t> next(cellStart.begin(), cellStart.end() - 1);
+            for (uint32_t i = 0; i < points.size(); i++)
+            {
+                uint32_t slot = next[cellOf(points[i])]++;
+                order[slot] = i;
+                xs[slot] = points[i].x;
+                ys[slot] = points[i].y;
+            }
+        }
+
+        size_t cellOf(const Point &p) const
+        {
+            return static_cast<size_t>(p.y / cellSize) * columns + p.x / cellSize;
+        }
+
+        // calls f(vertex, squared distance) for every point in cell (column, row)
+        template <typename F>
+        void scanCell(int column, int row, const Point &from, F f) const
+        {
+            if (column < 0 || row < 0 || column >= columns || row >= rows)
+                return;
+
+            size_t cell = static_cast<size_t>(row) * columns + column;
+            for (uint32_t slot = cellStart[cell]; slot < cellStart[cell + 1]; slot++)
+            {
+                int64_t dx = xs[slot] - from.x;
+                int64_t dy = ys[slot] - from.y;
+                f(order[slot], dx * dx + dy * dy);
+            }
+        }
+
+        // scans the cells at Chebyshev distance "ring" from (column, row)
+        template <typename F>
+        void scanRing(int column, int row, int ring, const Point &from, F f) const
+        {
+            if (ring == 0)
+            {
+                scanCell(column, row, from, f);
+                return;
+            }
+            for (int i = -ring; i <= ring; i++)
+            {
+                scanCell(column + i, row - ring, from, f);
+                scanCell(column + i, row + ring, from, f);
+            }
+            for (int i = -ring + 1; i <= ring - 1; i++)
+            {
+                scanCell(column - ring, row + i, from, f);
+                scanCell(column + ring, row + i, from, f);
+            }
+        }
+    };
+
+    using Candidate = std::pair<int64_t, uint32_t>;
+
+    // the k nearest vertices of "vertex", closest first, ties broken by index
+    void findNearest(const PointGrid &grid, const std::vector<Point> &points, uint32_t vertex, unsigned k,
+                     std::vector<Candidate> &nearest)
+    {
+        nearest.clear();
+        const Point &from = points[vertex];
+        const int column = from.x / grid.cellSize;
+        const int row = from.y / grid.cellSize;
+        const int maxRing = std::max(grid.columns, grid.rows);
+
+        for (int ring = 0; ring <= maxRing; ring++)
+        {
+            grid.scanRing(column, row, ring, from, [&](uint32_t other, int64_t distance)
+            {
+                if (other == vertex)
+                    return;
+
+                Candidate candidate(distance, other);
+                if (nearest.size() == k && !(candidate < nearest.back()))
+                    return;
+                if (nearest.size() == k)
+                    nearest.pop_back();
+                nearest.insert(std::upper_bound(nearest.begin(), nearest.end(), candidate), candidate);
+            });
+
+            // every point outside the rings scanned so far is at least this far away
+            int64_t reach = static_cast<int64_t>(ring) * grid.cellSize;
+            if (nearest.size() == k && nearest.back().first < reach * reach)
+                break;
+        }
+    }
+}
+
+namespace generator
+{
+    std::vector<Point> generatePoints(const GeneratorOptions &options, ThreadPool &pool)
+    {
+        const int spacing = std::max(options.minSpacing, 1);
+        // keeping this far from the tile borders keeps points of different tiles apart
+        const int margin = options.minSpacing > 0 ? (spacing + 1) / 2 : 0;
+
+        if (options.width / CHUNK_COLUMNS <= 2 * margin || options.height / CHUNK_ROWS <= 2 * margin)
+            throw std::invalid_argument("Area too small for the vertex spacing");
+
+        std::vector<Point> points(options.vertexCount);
+
+        // one independent stream per tile
+        std::vector<uint64_t> seeds(CHUNK_COUNT);
+        SplitMix64 seeder(options.seed);
+        for (uint64_t &seed : seeds)
+        {
+            seed = seeder.next();
+        }
+
+        forEachChunk(pool, CHUNK_COUNT, [&](unsigned chunk)
+        {
+            const int left = options.width * static_cast<int64_t>(chunk % CHUNK_COLUMNS) / CHUNK_COLUMNS;
+            const int right = options.width * static_cast<int64_t>(chunk % CHUNK_COLUMNS + 1) / CHUNK_COLUMNS;
+            const int top = options.height * static_cast<int64_t>(chunk / CHUNK_COLUMNS) / CHUNK_ROWS;
+            const int bottom = options.height * static_cast<int64_t>(chunk / CHUNK_COLUMNS + 1) / CHUNK_ROWS;
+
+            const size_t first = options.vertexCount * chunk / CHUNK_COUNT;
+            const size_t last = options.vertexCount * (chunk + 1) / CHUNK_COUNT;
+
+            // spatial hash of the tile with cells of side "spacing"; two points
+            // in one cell would be too close, so a cell holds at most one
+            const int columns = (right - left) / spacing + 1;
+            const int rows = (bottom - top) / spacing + 1;
+            std::vector<int> occupant(static_cast<size_t>(columns) * rows, -1);
+
+            SplitMix64 random(seeds[chunk]);
+            int failures = 0;
+
+            for (size_t placed = first; placed < last;)
+            {
+                Point p;
+                p.x = left + margin + random.below(right - left - 2 * margin);
+                p.y = top + margin + random.below(bottom - top - 2 * margin);
+
+                const int column = (p.x - left) / spacing;
+                const int row = (p.y - top) / spacing;
+
+                bool tooClose = false;
+                for (int y = std::max(row - 1, 0); y <= std::min(row + 1, rows - 1) && !tooClose; y++)
+                {
+                    for (int x = std::max(column - 1, 0); x <= std::min(column + 1, columns - 1); x++)
+                    {
+                        int other = occupant[static_cast<size_t>(y) * columns + x];
+                        if (other != -1 && std::abs(points[other].x - p.x) < spacing &&
+                            std::abs(points[other].y - p.y) < spacing)
+                        {
+                            tooClose = true;
+                            break;
+                        }
+                    }
+                }
+
+                if (tooClose && options.minSpacing > 0)
+                {
+                    if (++failures > MAX_FAILURES)
+                        throw std::runtime_error("Too many vertices for the area");
+                    continue;
+                }
+
+                failures = 0;
+                occupant[static_cast<size_t>(row) * columns + column] = placed;
+                points[placed++] = p;
+            }
+        });
+
+        return points;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> connectPoints(const std::vector<Point> &points,
+                                                             const GeneratorOptions &options, ThreadPool &pool)
+    {
+        using Edge = std::pair<uint32_t, uint32_t>;
+
+        const uint32_t vertexCount = points.size();
+        if (vertexCount == 0)
+            return {};
+
+        // about two points per cell for the neighbor search, the radius itself otherwise
+        int cellSize = options.radius;
+        if (cellSize <= 0)
+        {
+            double area = static_cast<double>(options.width) * options.height;
+            cellSize = std::max(1, static_cast<int>(std::sqrt(2 * area / vertexCount)));
+        }
+        const PointGrid grid(points, options.width, options.height, cellSize);
+
+        std::vector<std::vector<Edge>> chunkEdges(CHUNK_COUNT);
+        forEachChunk(pool, CHUNK_COUNT, [&](unsigned chunk)
+        {
+            const uint32_t first = static_cast<uint64_t>(vertexCount) * chunk / CHUNK_COUNT;
+            const uint32_t last = static_cast<uint64_t>(vertexCount) * (chunk + 1) / CHUNK_COUNT;
+            std::vector<Edge> &edges = chunkEdges[chunk];
+            std::vector<Candidate> nearest;
+
+            for (uint32_t vertex = first; vertex < last; vertex++)
+            {
+                if (options.radius > 0)
+                {
+                    const int64_t limit = static_cast<int64_t>(options.radius) * options.radius;
+                    const int column = points[vertex].x / cellSize;
+                    const int row = points[vertex].y / cellSize;
+                    for (int ring = 0; ring <= 1; ring++)
+                    {
+                        grid.scanRing(column, row, ring, points[vertex], [&](uint32_t other, int64_t distance)
+                        {
+                            // each pair is found from both ends, keep one
+                            if (vertex < other && distance < limit)
+                                edges.push_back({vertex, other});
+                        });
+                    }
+                }
+                else
+                {
+                    findNearest(grid, points, vertex, options.nearestNeighbors, nearest);
+                    for (const Candidate &candidate : nearest)
+                    {
+                        edges.push_back({std::min(vertex, candidate.second), std::max(vertex, candidate.second)});
+                    }
+                }
+            }
+
+            std::sort(edges.begin(), edges.end());
+        });
+
+        std::vector<Edge> edges;
+        for (const std::vector<Edge> &part : chunkEdges)
+        {
+            edges.insert(edges.end(), part.begin(), part.end());
+        }
+
+        // neighbor relations are not symmetric, so a pair may come from both ends
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        return edges;
+    }
+
+    DynamicGraph generateGraph(const GeneratorOptions &options, ThreadPool &pool)
+    {
+        std::vector<Point> points = generatePoints(options, pool);
+        std::vector<std::pair<uint32_t, uint32_t>> edges = connectPoints(points, options, pool);
+
+        DynamicGraph g;
+        g.reserve(points.size());
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            g.addVertex('A' + i % 26, points[i]);
+        }
+        for (const auto &edge : edges)
+        {
+            g.addEdge(edge.first, edge.second);
+        }
+
+        return g;
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "dynamic_graph.h"
+#include "geometry.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Random geometric graphs for benchmarks, up to millions of vertices.
+//
+// Vertices are scattered uniformly and kept at least minSpacing apart (in x
+// or in y) with a spatial hash instead of comparing against every placed
+// vertex. Edges join each vertex to its nearest neighbors, or to every vertex
+// within a radius, instead of flipping a coin for every pair. Both steps run
+// on a thread pool but split the work into a fixed number of chunks, each with
+// its own random stream, so a seed yields the same graph on any thread count.
+namespace generator
+{
+    struct GeneratorOptions
+    {
+        size_t vertexCount = 1000;
+        int width = 1200;
+        int height = 960;
+        // vertices closer than this in both x and y are rejected, 0 allows any
+        int minSpacing = 5;
+        // edges to the k nearest vertices
+        unsigned nearestNeighbors = 6;
+        // when positive, edges to every vertex closer than this instead
+        int radius = 0;
+        uint64_t seed = 1;
+    };
+
+    // Small, fast and seedable; unlike the standard distributions its output
+    // does not depend on the standard library implementation.
+    class SplitMix64
+    {
+    private:
+        uint64_t state;
+
+    public:
+        explicit SplitMix64(uint64_t seed) : state(seed)
+        {
+        }
+
+        uint64_t next()
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        // uniform in 0 .. bound - 1
+        uint32_t below(uint32_t bound)
+        {
+            return static_cast<uint32_t>((next() >> 32) * bound >> 32);
+        }
+    };
+
+    // Throws std::invalid_argument for a bad area and std::runtime_error when
+    // the vertices do not fit at the requested spacing.
+    std::vector<Point> generatePoints(const GeneratorOptions &options, ThreadPool &pool);
+
+    // undirected edges as sorted (smaller, larger) vertex pairs
+    std::vector<std::pair<uint32_t, uint32_t>> connectPoints(const std::vector<Point> &points,
+                                                             const GeneratorOptions &options, ThreadPool &pool);
+
+    DynamicGraph generateGraph(const GeneratorOptions &options, ThreadPool &pool);
+}
@@ -0,0 +1,408 @@
+#include "graph_import.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // bytes read per worker and batch
+    const size_t CHUNK_BYTES = 4 << 20;
+
+    template <typename Record>
+    struct ChunkOutput
+    {
+        std::vector<Record> records;
+        // vertex count from a "p" line, -1 when the chunk has none
+        int64_t declaredCount = -1;
+        uint64_t lines = 0;
+    };
+
+    std::runtime_error malformedLine(const char *begin, const char *end)
+    {
+        size_t length = std::min<size_t>(end - begin, 80);
+        return std::runtime_error("Malformed line: " + std::string(begin, length));
+    }
+
+    void skipSpaces(const char *&p, const char *end)
+    {
+        while (p != end && (*p == ' ' || *p == '\t'))
+            p++;
+    }
+
+    void skipToken(const char *&p, const char *end)
+    {
+        skipSpaces(p, end);
+        while (p != end && *p != ' ' && *p != '\t')
+            p++;
+    }
+
+    // false when there are no digits or the number does not fit in int64_t
+    bool readInteger(const char *&p, const char *end, int64_t &value)
+    {
+        skipSpaces(p, end);
+
+        bool negative = p != end && *p == '-';
+        if (negative)
+            p++;
+
+        const char *digits = p;
+        value = 0;
+        while (p != end && *p >= '0' && *p <= '9')
+        {
+            const int digit = *p - '0';
+            if (value > (INT64_MAX - digit) / 10)
+                return false;
+            value = value * 10 + digit;
+            p++;
+        }
+        if (negative)
+            value = -value;
+
+        return p != digits;
+    }
+
+    // first integer of a "p" line, skipping the words before it
+    bool readDeclaredCount(const char *p, const char *end, int64_t &value)
+    {
+        while (p != end)
+        {
+            const char *token = p;
+            if (readInteger(p, end, value))
+                return true;
+            // a number that failed to parse is too large, not a word to skip
+            if (p != token && p[-1] >= '0' && p[-1] <= '9')
+                return false;
+            p = token;
+            skipToken(p, end);
+            skipSpaces(p, end);
+        }
+        return false;
+    }
+
+    // Reads "path" in batches of one chunk per worker, calls
+    // parseLine(begin, end, output) for every non-empty line in parallel, and
+    // hands the records of each batch to consume(records) in file order, so
+    // only one batch of records is held at a time.
+    template <typename Record, typename ParseLine, typename Consume>
+    void readChunked(const std::string &path, ThreadPool &pool, graphimport::ImportStats &stats,
+                     int64_t &declaredCount, ParseLine parseLine, Consume consume)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            throw std::runtime_error("Cannot open " + path);
+
+        const unsigned workerCount = pool.getThreadCount();
+        std::vector<std::vector<char>> chunks(workerCount);
+        std::vector<ChunkOutput<Record>> outputs(workerCount);
+        // unfinished last line of the previous chunk
+        std::vector<char> carry;
+        bool endOfFile = false;
+
+        while (!endOfFile)
+        {
+            unsigned filled = 0;
+            for (; filled < workerCount && !endOfFile; filled++)
+            {
+                std::vector<char> &chunk = chunks[filled];
+                chunk.swap(carry);
+                carry.clear();
+
+                size_t used = chunk.size();
+                chunk.resize(used + CHUNK_BYTES);
+                file.read(chunk.data() + used, CHUNK_BYTES);
+                size_t got = file.gcount();
+                chunk.resize(used + got);
+                stats.bytes += got;
+
+                if (got < CHUNK_BYTES)
+                {
+                    endOfFile = true;
+                    break;
+                }
+
+                // cut after the last complete line
+                auto lastNewline = std::find(chunk.rbegin(), chunk.rend(), '\n');
+                size_t cut = chunk.rend() - lastNewline;
+                carry.assign(chunk.begin() + cut, chunk.end());
+                chunk.resize(cut);
+            }
+            if (endOfFile)
+                filled++;
+
+            pool.run([&](unsigned workerIndex)
+            {
+                if (workerIndex >= filled)
+                    return;
+
+                const std::vector<char> &chunk = chunks[workerIndex];
+                ChunkOutput<Record> &output = outputs[workerIndex];
+                const char *p = chunk.data();
+                const char *end = p + chunk.size();
+
+                while (p != end)
+                {
+                    const char *newline = static_cast<const char *>(std::memchr(p, '\n', end - p));
+                    const char *lineEnd = newline ? newline : end;
+                    const char *contentEnd = lineEnd != p && lineEnd[-1] == '\r' ? lineEnd - 1 : lineEnd;
+
+                    const char *first = p;
+                    skipSpaces(first, contentEnd);
+                    if (first != contentEnd)
+                    {
+                        parseLine(first, contentEnd, output);
+                        output.lines++;
+                    }
+
+                    p = newline ? newline + 1 : end;
+                }
+            });
+
+            for (unsigned i = 0; i < filled; i++)
+            {
+                ChunkOutput<Record> &output = outputs[i];
+                consume(output.records);
+                if (output.declaredCount != -1)
+                    declaredCount = output.declaredCount;
+                stats.lines += output.lines;
+
+                output.records.clear();
+                output.declaredCount = -1;
+                output.lines = 0;
+            }
+        }
+    }
+
+    // The arc files become CSR arrays in two passes: the first counts the
+    // out-degree of every vertex, the second reads the file again and writes
+    // each arc into its slot. Peak memory is the finished graph plus one
+    // counter per vertex and one batch of parsed arcs, instead of a second
+    // copy of every arc. Arcs of a vertex keep their file order.
+    struct ArcCounts
+    {
+        // offsets[v + 1] counts the arcs leaving v until turned into prefix sums
+        std::vector<uint32_t> offsets = {0};
+        int64_t declaredCount = -1;
+    };
+
+    // first pass, counts the arcs leaving every vertex
+    template <typename ParseLine>
+    ArcCounts countArcs(const std::string &path, ThreadPool &pool, graphimport::ImportStats &stats,
+                        ParseLine parseLine)
+    {
+        ArcCounts counts;
+        uint64_t arcCount = 0;
+        readChunked<CsrGraph::Arc>(path, pool, stats, counts.declaredCount, parseLine,
+                                   [&](const std::vector<CsrGraph::Arc> &arcs)
+        {
+            for (const CsrGraph::Arc &arc : arcs)
+            {
+                const size_t needed = static_cast<size_t>(std::max(arc.from, arc.to)) + 2;
+                if (counts.offsets.size() < needed)
+                    counts.offsets.resize(needed, 0);
+                counts.offsets[arc.from + 1]++;
+            }
+            arcCount += arcs.size();
+        });
+
+        if (arcCount > UINT32_MAX)
+            throw std::runtime_error("More arcs than the graph can index in " + path);
+
+        if (counts.declaredCount >= 0)
+        {
+            if (counts.offsets.size() > static_cast<uint64_t>(counts.declaredCount) + 1)
+                throw std::out_of_range("Arc references a missing vertex");
+            counts.offsets.resize(counts.declaredCount + 1, 0);
+        }
+
+        for (size_t i = 1; i < counts.offsets.size(); i++)
+        {
+            counts.offsets[i] += counts.offsets[i - 1];
+        }
+        return counts;
+    }
+
+    // second pass, writes every arc into the slot the counts reserved for it
+    template <typename ParseLine>
+    void fillArcs(const std::string &path, ThreadPool &pool, const std::vector<uint32_t> &offsets,
+                  std::vector<uint32_t> &neighbors, std::vector<int> &weights, ParseLine parseLine)
+    {
+        neighbors.resize(offsets.back());
+        weights.resize(offsets.back());
+
+        std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+        graphimport::ImportStats ignored;
+        int64_t declaredCount = -1;
+        readChunked<CsrGraph::Arc>(path, pool, ignored, declaredCount, parseLine,
+                                   [&](const std::vector<CsrGraph::Arc> &arcs)
+        {
+            for (const CsrGraph::Arc &arc : arcs)
+            {
+                // the file changed between the passes
+                if (arc.from >= next.size() || next[arc.from] == offsets[arc.from + 1])
+                    throw std::runtime_error("Arcs differ between the two passes");
+                const uint32_t slot = next[arc.from]++;
+                neighbors[slot] = arc.to;
+                weights[slot] = arc.weight;
+            }
+        });
+    }
+
+    std::vector<char> makeNames(uint32_t vertexCount)
+    {
+        std::vector<char> names(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; i++)
+        {
+            names[i] = 'A' + i % 26;
+        }
+        return names;
+    }
+
+    bool validId(int64_t id, int64_t base)
+    {
+        return id >= base && id - base < UINT32_MAX;
+    }
+}
+
+namespace graphimport
+{
+    CsrGraph importDimacs(const std::string &graphPath, const std::string &coordinatePath, ThreadPool &pool,
+                          ImportStats *stats)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        ImportStats local;
+
+        auto parseArc = [](const char *line, const char *end, ChunkOutput<CsrGraph::Arc> &output)
+        {
+            const char *p = line + 1;
+            int64_t from, to, weight;
+
+            switch (*line)
+            {
+            case 'c':
+                return;
+            case 'p':
+                if (!readDeclaredCount(p, end, output.declaredCount))
+                    throw malformedLine(line, end);
+                return;
+            case 'a':
+                if (!readInteger(p, end, from) || !readInteger(p, end, to) || !readInteger(p, end, weight) ||
+                    !validId(from, 1) || !validId(to, 1) || weight < 0 || weight > INT32_MAX)
+                    throw malformedLine(line, end);
+                output.records.push_back({static_cast<uint32_t>(from - 1), static_cast<uint32_t>(to - 1),
+                                          static_cast<int>(weight)});
+                return;
+            default:
+                throw malformedLine(line, end);
+            }
+        };
+
+        ArcCounts counts = countArcs(graphPath, pool, local, parseArc);
+        const uint32_t vertexCount = counts.offsets.size() - 1;
+        std::vector<Point> coordinates(vertexCount, Point{0, 0});
+
+        if (!coordinatePath.empty())
+        {
+            struct Coordinate
+            {
+                uint32_t vertex;
+                Point position;
+            };
+
+            int64_t declaredCoordinates = -1;
+            readChunked<Coordinate>(coordinatePath, pool, local, declaredCoordinates,
+                                    [](const char *line, const char *end, ChunkOutput<Coordinate> &output)
+            {
+                const char *p = line + 1;
+                int64_t id, x, y;
+
+                switch (*line)
+                {
+                case 'c':
+                    return;
+                case 'p':
+                    if (!readDeclaredCount(p, end, output.declaredCount))
+                        throw malformedLine(line, end);
+                    return;
+                case 'v':
+                    if (!readInteger(p, end, id) || !readInteger(p, end, x) || !readInteger(p, end, y) ||
+                        !validId(id, 1) || x < INT32_MIN || x > INT32_MAX || y < INT32_MIN || y > INT32_MAX)
+                        throw malformedLine(line, end);
+                    output.records.push_back({static_cast<uint32_t>(id - 1), {static_cast<int>(x), static_cast<int>(y)}});
+                    return;
+                default:
+                    throw malformedLine(line, end);
+                }
+            },
+                                    [&](const std::vector<Coordinate> &records)
+            {
+                for (const Coordinate &record : records)
+                {
+                    if (record.vertex >= vertexCount)
+                        throw std::out_of_range("Coordinate of a missing vertex");
+                    coordinates[record.vertex] = record.position;
+                }
+            });
+        }
+
+        std::vector<uint32_t> neighbors;
+        std::vector<int> weights;
+        fillArcs(graphPath, pool, counts.offsets, neighbors, weights, parseArc);
+        CsrGraph g(makeNames(vertexCount), std::move(coordinates), std::move(counts.offsets), std::move(neighbors),
+                   std::move(weights));
+
+        auto end = std::chrono::steady_clock::now();
+        local.seconds = std::chrono::duration<double>(end - begin).count();
+        if (stats)
+            *stats = local;
+
+        return g;
+    }
+
+    CsrGraph importEdgeList(const std::string &path, const EdgeListOptions &options, ThreadPool &pool,
+                            ImportStats *stats)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        ImportStats local;
+
+        auto parseArc = [&](const char *line, const char *end, ChunkOutput<CsrGraph::Arc> &output)
+        {
+            if (*line == '#' || *line == '%')
+                return;
+
+            const char *p = line;
+            int64_t from, to, weight = options.defaultWeight;
+            if (!readInteger(p, end, from) || !readInteger(p, end, to) || !validId(from, 0) || !validId(to, 0))
+                throw malformedLine(line, end);
+
+            skipSpaces(p, end);
+            if (p != end && (!readInteger(p, end, weight) || weight < 0 || weight > INT32_MAX))
+                throw malformedLine(line, end);
+
+            CsrGraph::Arc arc = {static_cast<uint32_t>(from), static_cast<uint32_t>(to), static_cast<int>(weight)};
+            output.records.push_back(arc);
+            if (!options.directed)
+                output.records.push_back({arc.to, arc.from, arc.weight});
+        };
+
+        ArcCounts counts = countArcs(path, pool, local, parseArc);
+        const uint32_t vertexCount = counts.offsets.size() - 1;
+
+        std::vector<uint32_t> neighbors;
+        std::vector<int> weights;
+        fillArcs(path, pool, counts.offsets, neighbors, weights, parseArc);
+
+        CsrGraph g(makeNames(vertexCount), std::vector<Point>(vertexCount, Point{0, 0}), std::move(counts.offsets),
+                   std::move(neighbors), std::move(weights));
+
+        auto end = std::chrono::steady_clock::now();
+        local.seconds = std::chrono::duration<double>(end - begin).count();
+        if (stats)
+            *stats = local;
+
+        return g;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "csr_graph.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <string>
+
+// Streaming importers for standard graph datasets.
+//
+// Files are read in fixed-size chunks cut at line boundaries. Each batch of
+// chunks, one per worker of the pool, is parsed in parallel and consumed in
+// file order, so the result does not depend on the thread count. Arc files
+// are read twice, once to count the out-degrees and once to write the arcs
+// straight into the CSR arrays: peak memory is the finished graph, one
+// counter per vertex and one batch (a 4 MiB chunk and its parsed arcs per
+// worker), never a second copy of all arcs. The paths must therefore name
+// regular files, not pipes. Malformed lines throw std::runtime_error quoting
+// the line.
+namespace graphimport
+{
+    struct ImportStats
+    {
+        uint64_t bytes = 0;
+        uint64_t lines = 0;
+        double seconds = 0;
+
+        double getMegabytesPerSecond() const
+        {
+            return seconds > 0 ? bytes / 1e6 / seconds : 0;
+        }
+    };
+
+    struct EdgeListOptions
+    {
+        // each line is an arc instead of an undirected edge
+        bool directed = false;
+        // weight of lines with only two columns
+        int defaultWeight = 1;
+    };
+
+    // DIMACS 9th challenge shortest path files: "a u v w" arcs from the .gr
+    // file, "v id x y" coordinates from the .co file (pass "" for none).
+    // Vertex ids are 1-based in the files and 0-based in the graph; arcs stay
+    // directed as listed.
+    CsrGraph importDimacs(const std::string &graphPath, const std::string &coordinatePath, ThreadPool &pool,
+                          ImportStats *stats = nullptr);
+
+    // Plain "u v [weight]" lines with 0-based ids; lines starting with '#' or
+    // '%' are comments. Vertices get zero coordinates.
+    CsrGraph importEdgeList(const std::string &path, const EdgeListOptions &options, ThreadPool &pool,
+                            ImportStats *stats = nullptr);
+}
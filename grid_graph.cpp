@@ -0,0 +1,263 @@
+#include "grid_graph.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+HeuristicModes GridGraph::heuristicMode = HeuristicModes::octile;
+
+namespace
+{
+    int sign(int value)
+    {
+        return (value > 0) - (value < 0);
+    }
+}
+
+GridGraph::GridGraph(uint32_t width, uint32_t height, int cellSize)
+    : width(width), height(height), cellSize(cellSize),
+      blocked((static_cast<size_t>(width) * height + 63) / 64, 0)
+{
+}
+
+void GridGraph::setHeuristic(HeuristicModes heuristic)
+{
+    heuristicMode = heuristic;
+}
+
+bool GridGraph::isBlocked(int vertex) const
+{
+    return blocked[vertex >> 6] >> (vertex & 63) & 1;
+}
+
+void GridGraph::setBlocked(int vertex, bool value)
+{
+    if (static_cast<uint32_t>(vertex) >= getVertexCount())
+        throw std::out_of_range("Cell outside of the grid");
+
+    uint64_t bit = uint64_t(1) << (vertex & 63);
+    if (value)
+        blocked[vertex >> 6] |= bit;
+    else
+        blocked[vertex >> 6] &= ~bit;
+}
+
+bool GridGraph::hasForcedNeighbor(int x, int y, int dx, int dy) const
+{
+    // the cell beside the current one is free but the one beside the previous
+    // cell is not, so the previous cell could not reach it diagonally
+    if (dx != 0)
+    {
+        return (isWalkable(x, y + 1) && !isWalkable(x - dx, y + 1)) ||
+               (isWalkable(x, y - 1) && !isWalkable(x - dx, y - 1));
+    }
+    return (isWalkable(x + 1, y) && !isWalkable(x + 1, y - dy)) ||
+           (isWalkable(x - 1, y) && !isWalkable(x - 1, y - dy));
+}
+
+unsigned GridGraph::getJumpDirections(int x, int y, int dx, int dy) const
+{
+    if (dx == 0 && dy == 0)
+        return 0xFF;
+
+    if (dx != 0 && dy != 0)
+    {
+        // diagonal moves have no forced neighbors when corners cannot be cut
+        return 1u << getGridDirection(dx, 0) | 1u << getGridDirection(0, dy) | 1u << getGridDirection(dx, dy);
+    }
+
+    unsigned mask = 1u << getGridDirection(dx, dy);
+    for (int side = -1; side <= 1; side += 2)
+    {
+        if (dx != 0 && isWalkable(x, y + side) && !isWalkable(x - dx, y + side))
+            mask |= 1u << getGridDirection(0, side) | 1u << getGridDirection(dx, side);
+        if (dy != 0 && isWalkable(x + side, y) && !isWalkable(x + side, y - dy))
+            mask |= 1u << getGridDirection(side, 0) | 1u << getGridDirection(side, dy);
+    }
+    return mask;
+}
+
+char GridGraph::getVertexName(int vertex) const
+{
+    return isBlocked(vertex) ? '#' : '.';
+}
+
+uint32_t GridGraph::getVertexCount() const
+{
+    return width * height;
+}
+
+Point GridGraph::getCoordinate(int vertex) const
+{
+    return {static_cast<int>(vertex % width) * GRID_STRAIGHT_COST, static_cast<int>(vertex / width) * GRID_STRAIGHT_COST};
+}
+
+int GridGraph::getNearbyVertex(const Point &pos) const
+{
+    if (pos.x < 0 || pos.y < 0)
+        return -1;
+
+    uint32_t x = pos.x / cellSize;
+    uint32_t y = pos.y / cellSize;
+    if (x >= width || y >= height)
+        return -1;
+
+    return getVertex(x, y);
+}
+
+std::vector<int> GridGraph::djikstra(int start) const
+{
+    return search::djikstra(*this, start);
+}
+
+size_t GridGraph::djikstra(int start, int *distances, const search::DijkstraLimits &limits) const
+{
+    return search::djikstra(*this, start, distances, limits);
+}
+
+int GridGraph::heuristic(int current, int finish) const
+{
+    return search::heuristic(*this, heuristicMode, current, finish);
+}
+
+int GridGraph::jumpStraight(int x, int y, int dx, int dy, int finish) const
+{
+    while (isWalkable(x + dx, y + dy))
+    {
+        x += dx;
+        y += dy;
+
+        int vertex = getVertex(x, y);
+        if (vertex == finish || hasForcedNeighbor(x, y, dx, dy))
+            return vertex;
+    }
+    return -1;
+}
+
+int GridGraph::jump(int x, int y, int dx, int dy, int finish) const
+{
+    if (dx == 0 || dy == 0)
+        return jumpStraight(x, y, dx, dy, finish);
+
+    while (isWalkable(x + dx, y) && isWalkable(x, y + dy) && isWalkable(x + dx, y + dy))
+    {
+        x += dx;
+        y += dy;
+
+        // a diagonal stops wherever one of its straight components finds something
+        int vertex = getVertex(x, y);
+        if (vertex == finish || jumpStraight(x, y, dx, 0, finish) != -1 || jumpStraight(x, y, 0, dy, finish) != -1)
+            return vertex;
+    }
+    return -1;
+}
+
+std::vector<int> GridGraph::jumpPointSearch(int start, int finish) const
+{
+    SearchWorkspace<> &workspace = threadWorkspace<>();
+
+    if (!jumpPointSearch(start, finish, workspace))
+        throw std::logic_error("Not path found");
+
+    return workspace.path;
+}
+
+bool GridGraph::jumpPointSearch(int start, int finish, SearchWorkspace<> &workspace) const
+{
+    workspace.reset(getVertexCount());
+    BinaryHeap &openSet = workspace.openSet;
+
+    if (isBlocked(start) || isBlocked(finish))
+        return false;
+
+    auto heuristic = makePointHeuristic(*this, OctileHeuristic(), finish);
+
+    workspace.setScore(start, 0, -1);
+    workspace.push(start, heuristic(start));
+    ASTAR_STATS(workspace.stats.heuristicEvaluations++);
+
+    while (!openSet.empty())
+    {
+        int currentVertex = workspace.settle();
+
+        if (currentVertex == finish)
+        {
+            unpackJumpPath(finish, workspace);
+            return true;
+        }
+
+        const int x = currentVertex % width;
+        const int y = currentVertex / width;
+        const int currentGScore = workspace.getGScore(currentVertex);
+
+        // the direction we came from decides which moves are worth trying
+        int dx = 0, dy = 0;
+        int parent = workspace.getCameFrom(currentVertex);
+        if (parent != -1)
+        {
+            dx = sign(x - static_cast<int>(parent % width));
+            dy = sign(y - static_cast<int>(parent / width));
+        }
+
+        unsigned directions = getJumpDirections(x, y, dx, dy);
+        for (int direction = 0; direction < 8; direction++)
+        {
+            if (!(directions >> direction & 1))
+                continue;
+
+            int jumpPoint = jump(x, y, GRID_DX[direction], GRID_DY[direction], finish);
+            if (jumpPoint == -1)
+                continue;
+
+            // every jump is a straight or a diagonal line
+            int steps = std::max(std::abs(static_cast<int>(jumpPoint % width) - x), std::abs(static_cast<int>(jumpPoint / width) - y));
+            int newGScore = currentGScore + steps * (direction < 4 ? GRID_STRAIGHT_COST : GRID_DIAGONAL_COST);
+            ASTAR_STATS(workspace.stats.relaxed++);
+
+            if (newGScore < workspace.getGScore(jumpPoint))
+            {
+                workspace.setScore(jumpPoint, newGScore, currentVertex);
+                workspace.push(jumpPoint, newGScore + heuristic(jumpPoint));
+                ASTAR_STATS(workspace.stats.heuristicEvaluations++);
+            }
+        }
+    }
+
+    return false;
+}
+
+void GridGraph::unpackJumpPath(int finish, SearchWorkspace<> &workspace) const
+{
+    std::vector<int> &path = workspace.path;
+    path.clear();
+
+    int vertex = finish;
+    path.push_back(vertex);
+
+    for (int jumpPoint = workspace.getCameFrom(finish); jumpPoint != -1; jumpPoint = workspace.getCameFrom(jumpPoint))
+    {
+        int dx = sign(static_cast<int>(jumpPoint % width) - static_cast<int>(vertex % width));
+        int dy = sign(static_cast<int>(jumpPoint / width) - static_cast<int>(vertex / width));
+        int step = getVertex(dx, dy);
+
+        while (vertex != jumpPoint)
+        {
+            vertex += step;
+            path.push_back(vertex);
+        }
+    }
+
+    std::reverse(path.begin(), path.end());
+}
+
+GridGraph GridGraph::getRandomGrid(uint32_t width, uint32_t height, int density, int cellSize)
+{
+    GridGraph g(width, height, cellSize);
+
+    for (uint32_t i = 0; i < g.getVertexCount(); i++)
+    {
+        if (rand() % 100 < density)
+            g.setBlocked(i, true);
+    }
+
+    return g;
+}
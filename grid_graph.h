@@ -0,0 +1,184 @@
+#pragma once
+
+#include "geometry.h"
+#include "search.h"
+#include <cstdint>
+#include <vector>
+
+// move costs, 99 / 70 is just above sqrt(2) so euclidean and octile stay admissible
+const int GRID_STRAIGHT_COST = 70;
+const int GRID_DIAGONAL_COST = 99;
+
+// the 8 moves, straight ones first; bit i of a direction mask stands for move i
+const int GRID_DX[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+const int GRID_DY[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+// index of the move (dx, dy) in GRID_DX / GRID_DY, each of dx and dy in -1 .. 1
+inline int getGridDirection(int dx, int dy)
+{
+    if (dx == 0)
+        return dy > 0 ? 2 : 3;
+    if (dy == 0)
+        return dx > 0 ? 0 : 1;
+    return 4 + (dx > 0 ? 0 : 2) + (dy > 0 ? 0 : 1);
+}
+
+// 8-connected occupancy grid.
+//
+// Cell (x, y) is vertex y * width + x. Obstacles take one bit per cell and the
+// moves are derived from them in forEachNeighbor, so no edges are stored at
+// all. A diagonal move may not cut a corner: both cells it passes between have
+// to be free.
+//
+// Besides the generic searches the grid offers Jump Point Search, which only
+// expands the cells where an optimal path may turn; see JumpTable for the
+// precomputed JPS+ variant.
+class GridGraph
+{
+private:
+    uint32_t width = 0;
+    uint32_t height = 0;
+    // side of a cell on screen, in pixels
+    int cellSize = 16;
+    std::vector<uint64_t> blocked;
+    static HeuristicModes heuristicMode;
+
+    int jumpStraight(int x, int y, int dx, int dy, int finish) const;
+
+    // next jump point from (x, y) in direction (dx, dy), -1 when there is none
+    int jump(int x, int y, int dx, int dy, int finish) const;
+
+public:
+    GridGraph() = default;
+
+    GridGraph(uint32_t width, uint32_t height, int cellSize = 16);
+
+    static void setHeuristic(HeuristicModes);
+
+    uint32_t getWidth() const
+    {
+        return width;
+    }
+
+    uint32_t getHeight() const
+    {
+        return height;
+    }
+
+    int getCellSize() const
+    {
+        return cellSize;
+    }
+
+    int getVertex(int x, int y) const
+    {
+        return y * static_cast<int>(width) + x;
+    }
+
+    bool isWalkable(int x, int y) const
+    {
+        if (static_cast<uint32_t>(x) >= width || static_cast<uint32_t>(y) >= height)
+            return false;
+        uint32_t cell = y * width + x;
+        return !(blocked[cell >> 6] >> (cell & 63) & 1);
+    }
+
+    bool isBlocked(int vertex) const;
+
+    void setBlocked(int vertex, bool value);
+
+    // Whether a straight move in direction (dx, dy) into (x, y) leaves a cell
+    // beside (x, y) that only an optimal path through (x, y) can reach.
+    bool hasForcedNeighbor(int x, int y, int dx, int dy) const;
+
+    // Mask of the moves worth trying from (x, y) when it was entered moving in
+    // direction (dx, dy): the natural ones plus the forced ones. (0, 0) is the
+    // start cell, which tries all 8.
+    unsigned getJumpDirections(int x, int y, int dx, int dy) const;
+
+    char getVertexName(int vertex) const;
+
+    uint32_t getVertexCount() const;
+
+    // cell centre in cost units, so the coordinate heuristics match the move costs
+    Point getCoordinate(int vertex) const;
+
+    // calls f(neighbor, weight) for every move out of "vertex"
+    template <typename F>
+    void forEachNeighbor(int vertex, F f) const;
+
+    // cell under the screen position "pos", -1 outside of the grid
+    int getNearbyVertex(const Point &pos) const;
+
+    std::vector<int> djikstra(int start) const;
+
+    size_t djikstra(int start, int *distances, const search::DijkstraLimits &limits = {}) const;
+
+    int heuristic(int current, int finish) const;
+
+    template <typename OpenSet = BinaryHeap>
+    std::vector<int> aStarSearch(int start, int finish) const;
+
+    // allocation-free variant, the path is left in workspace.path
+    template <typename OpenSet>
+    bool aStarSearch(int start, int finish, SearchWorkspace<OpenSet> &workspace) const;
+
+    // Jump Point Search with the octile heuristic; returns the same cell by cell
+    // path as aStarSearch and throws when there is none
+    std::vector<int> jumpPointSearch(int start, int finish) const;
+
+    bool jumpPointSearch(int start, int finish, SearchWorkspace<> &workspace) const;
+
+    // fills workspace.path with every cell between the jump points stored in
+    // the cameFrom chain of "finish"
+    void unpackJumpPath(int finish, SearchWorkspace<> &workspace) const;
+
+    // blocks about "density" percent of the cells
+    static GridGraph getRandomGrid(uint32_t width, uint32_t height, int density, int cellSize = 16);
+};
+
+template <typename OpenSet>
+std::vector<int> GridGraph::aStarSearch(int start, int finish) const
+{
+    return search::aStarSearch<OpenSet>(*this, start, finish, heuristicMode);
+}
+
+template <typename OpenSet>
+bool GridGraph::aStarSearch(int start, int finish, SearchWorkspace<OpenSet> &workspace) const
+{
+    return search::aStarSearch(*this, start, finish, heuristicMode, workspace);
+}
+
+template <typename F>
+void GridGraph::forEachNeighbor(int vertex, F f) const
+{
+    const int x = vertex % width;
+    const int y = vertex / width;
+
+    if (!isWalkable(x, y))
+        return;
+
+    const bool left = isWalkable(x - 1, y);
+    const bool right = isWalkable(x + 1, y);
+    const bool up = isWalkable(x, y - 1);
+    const bool down = isWalkable(x, y + 1);
+    const int row = width;
+
+    if (left)
+        f(vertex - 1, GRID_STRAIGHT_COST);
+    if (right)
+        f(vertex + 1, GRID_STRAIGHT_COST);
+    if (up)
+        f(vertex - row, GRID_STRAIGHT_COST);
+    if (down)
+        f(vertex + row, GRID_STRAIGHT_COST);
+
+    if (left && up && isWalkable(x - 1, y - 1))
+        f(vertex - row - 1, GRID_DIAGONAL_COST);
+    if (right && up && isWalkable(x + 1, y - 1))
+        f(vertex - row + 1, GRID_DIAGONAL_COST);
+    if (left && down && isWalkable(x - 1, y + 1))
+        f(vertex + row - 1, GRID_DIAGONAL_COST);
+    if (right && down && isWalkable(x + 1, y + 1))
+        f(vertex + row + 1, GRID_DIAGONAL_COST);
+}
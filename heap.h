@@ -0,0 +1,361 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Indexed priority queues over vertex ids, used as the open set of the searches.
+//
+// Every open set policy provides the same interface, so a search can be
+// instantiated with any of them and benchmarked on the same graph:
+//   void reserve(size_t vertexCount);   // ids must be < vertexCount
+//   bool empty() const;
+//   size_t size() const;
+//   bool contains(int vertex) const;
+//   void push(int vertex, Key key);     // insert, or decrease the key if already queued
+//   Key topKey() const;
+//   int pop();                          // remove and return the vertex with the least key
+//   void clear();                       // O(size()), not O(vertexCount)
+//
+// DaryHeap additionally supports the arbitrary key changes the incremental
+// planners need:
+//   void update(int vertex, Key key);   // insert, or set the key even if it grows
+//   void remove(int vertex);            // no-op if the vertex is not queued
+
+// d-ary heap with a position index for decrease-key
+template <unsigned D, typename Key = int>
+class DaryHeap
+{
+    static_assert(D >= 2, "A heap needs at least two children per node");
+
+private:
+    struct Entry
+    {
+        Key key;
+        int vertex;
+    };
+
+    std::vector<Entry> heap;
+    // index of a vertex inside "heap", -1 if it is not queued
+    std::vector<int> position;
+
+    void place(size_t index, const Entry &entry)
+    {
+        heap[index] = entry;
+        position[entry.vertex] = index;
+    }
+
+    void siftUp(size_t index)
+    {
+        Entry entry = heap[index];
+        while (index > 0)
+        {
+            size_t parent = (index - 1) / D;
+            if (!(entry.key < heap[parent].key))
+                break;
+            place(index, heap[parent]);
+            index = parent;
+        }
+        place(index, entry);
+    }
+
+    void siftDown(size_t index)
+    {
+        Entry entry = heap[index];
+        const size_t count = heap.size();
+        while (true)
+        {
+            size_t first = index * D + 1;
+            if (first >= count)
+                break;
+
+            size_t last = first + D < count ? first + D : count;
+            size_t best = first;
+            for (size_t child = first + 1; child < last; child++)
+            {
+                if (heap[child].key < heap[best].key)
+                    best = child;
+            }
+
+            if (!(heap[best].key < entry.key))
+                break;
+            place(index, heap[best]);
+            index = best;
+        }
+        place(index, entry);
+    }
+
+public:
+    void reserve(size_t vertexCount)
+    {
+        if (position.size() < vertexCount)
+            position.resize(vertexCount, -1);
+    }
+
+    bool empty() const
+    {
+        return heap.empty();
+    }
+
+    size_t size() const
+    {
+        return heap.size();
+    }
+
+    bool contains(int vertex) const
+    {
+        return position[vertex] != -1;
+    }
+
+    void push(int vertex, Key key)
+    {
+        int index = position[vertex];
+        if (index == -1)
+        {
+            heap.push_back({key, vertex});
+            siftUp(heap.size() - 1);
+        }
+        else if (key < heap[index].key)
+        {
+            heap[index].key = key;
+            siftUp(index);
+        }
+    }
+
+    void update(int vertex, Key key)
+    {
+        int index = position[vertex];
+        if (index == -1)
+        {
+            heap.push_back({key, vertex});
+            siftUp(heap.size() - 1);
+            return;
+        }
+
+        bool decreased = key < heap[index].key;
+        heap[index].key = key;
+        if (decreased)
+            siftUp(index);
+        else
+            siftDown(index);
+    }
+
+    void remove(int vertex)
+    {
+        int index = position[vertex];
+        if (index == -1)
+            return;
+        position[vertex] = -1;
+
+        Entry last = heap.back();
+        heap.pop_back();
+        if (static_cast<size_t>(index) == heap.size())
+            return;
+
+        // the last entry fills the gap and may have to move either way
+        place(index, last);
+        if (index > 0 && last.key < heap[(index - 1) / D].key)
+            siftUp(index);
+        else
+            siftDown(index);
+    }
+
+    Key topKey() const
+    {
+        return heap.front().key;
+    }
+
+    int pop()
+    {
+        int top = heap.front().vertex;
+        position[top] = -1;
+
+        Entry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty())
+        {
+            heap[0] = last;
+            siftDown(0);
+        }
+        return top;
+    }
+
+    void clear()
+    {
+        for (const Entry &entry : heap)
+        {
+            position[entry.vertex] = -1;
+        }
+        heap.clear();
+    }
+};
+
+using BinaryHeap = DaryHeap<2>;
+using QuaternaryHeap = DaryHeap<4>;
+
+// pairing heap; nodes live in a vertex-indexed array so no allocation happens per push
+template <typename Key = int>
+class PairingHeap
+{
+private:
+    struct Node
+    {
+        Key key;
+        int child = -1;
+        int sibling = -1;
+        // parent for a leftmost child, left sibling otherwise
+        int previous = -1;
+        bool queued = false;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> pairs;
+    int root = -1;
+    size_t count = 0;
+
+    // links two roots, returns the new root
+    int meld(int a, int b)
+    {
+        if (a == -1)
+            return b;
+        if (b == -1)
+            return a;
+        if (nodes[b].key < nodes[a].key)
+            std::swap(a, b);
+
+        // b becomes the leftmost child of a
+        nodes[b].sibling = nodes[a].child;
+        if (nodes[a].child != -1)
+            nodes[nodes[a].child].previous = b;
+        nodes[b].previous = a;
+        nodes[a].child = b;
+        nodes[a].sibling = -1;
+        nodes[a].previous = -1;
+        return a;
+    }
+
+    void cut(int vertex)
+    {
+        Node &node = nodes[vertex];
+        Node &previous = nodes[node.previous];
+        if (previous.child == vertex)
+            previous.child = node.sibling;
+        else
+            previous.sibling = node.sibling;
+
+        if (node.sibling != -1)
+            nodes[node.sibling].previous = node.previous;
+
+        node.sibling = -1;
+        node.previous = -1;
+    }
+
+public:
+    void reserve(size_t vertexCount)
+    {
+        if (nodes.size() < vertexCount)
+            nodes.resize(vertexCount);
+    }
+
+    bool empty() const
+    {
+        return root == -1;
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    bool contains(int vertex) const
+    {
+        return nodes[vertex].queued;
+    }
+
+    void push(int vertex, Key key)
+    {
+        Node &node = nodes[vertex];
+        if (!node.queued)
+        {
+            node.key = key;
+            node.child = -1;
+            node.sibling = -1;
+            node.previous = -1;
+            node.queued = true;
+            count++;
+            root = meld(root, vertex);
+        }
+        else if (key < node.key)
+        {
+            node.key = key;
+            if (vertex != root)
+            {
+                cut(vertex);
+                root = meld(root, vertex);
+            }
+        }
+    }
+
+    Key topKey() const
+    {
+        return nodes[root].key;
+    }
+
+    int pop()
+    {
+        int top = root;
+        nodes[top].queued = false;
+        count--;
+
+        // two-pass pairing of the children of the old root
+        pairs.clear();
+        int child = nodes[top].child;
+        while (child != -1)
+        {
+            int first = child;
+            int second = nodes[first].sibling;
+            child = second != -1 ? nodes[second].sibling : -1;
+
+            nodes[first].sibling = -1;
+            nodes[first].previous = -1;
+            if (second != -1)
+            {
+                nodes[second].sibling = -1;
+                nodes[second].previous = -1;
+            }
+            pairs.push_back(meld(first, second));
+        }
+
+        root = -1;
+        for (size_t i = pairs.size(); i-- > 0;)
+        {
+            root = meld(pairs[i], root);
+        }
+
+        nodes[top].child = -1;
+        return top;
+    }
+
+    void clear()
+    {
+        pairs.clear();
+        if (root != -1)
+            pairs.push_back(root);
+
+        while (!pairs.empty())
+        {
+            int vertex = pairs.back();
+            pairs.pop_back();
+            for (int child = nodes[vertex].child; child != -1; child = nodes[child].sibling)
+            {
+                pairs.push_back(child);
+            }
+            nodes[vertex].queued = false;
+            nodes[vertex].child = -1;
+        }
+
+        root = -1;
+        count = 0;
+    }
+};
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "geometry.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+
+enum class HeuristicModes
+{
+    xDifference,
+    yDifference,
+    euclidean,
+    zero,
+    manhattan,
+    octile,
+    euclideanBound,
+    last
+};
+
+inline const char *getHeuristicName(HeuristicModes mode)
+{
+    switch (mode)
+    {
+    case HeuristicModes::zero:
+        return "zero";
+    case HeuristicModes::euclidean:
+        return "euclidean";
+    case HeuristicModes::euclideanBound:
+        return "euclideanBound";
+    case HeuristicModes::xDifference:
+        return "xDifference";
+    case HeuristicModes::yDifference:
+        return "yDifference";
+    case HeuristicModes::manhattan:
+        return "manhattan";
+    case HeuristicModes::octile:
+        return "octile";
+    default:
+        return "unknown";
+    }
+}
+
+// Heuristic policies. Each one is a stateless metric between two points that
+// the searches take as a template parameter, so the call is inlined into the
+// relaxation loop instead of going through a switch per edge.
+//
+// zero, xDifference, yDifference, euclidean and euclideanBound never exceed the
+// straight-line distance, so they are admissible for coordinate-derived weights.
+// manhattan and octile are for grid-like graphs whose moves are restricted to 4
+// or 8 directions; on free-form graphs they may overestimate.
+
+struct ZeroHeuristic
+{
+    int operator()(const Point &, const Point &) const
+    {
+        return 0;
+    }
+};
+
+struct XDifferenceHeuristic
+{
+    int operator()(const Point &a, const Point &b) const
+    {
+        return std::abs(a.x - b.x);
+    }
+};
+
+struct YDifferenceHeuristic
+{
+    int operator()(const Point &a, const Point &b) const
+    {
+        return std::abs(a.y - b.y);
+    }
+};
+
+struct EuclideanHeuristic
+{
+    int operator()(const Point &a, const Point &b) const
+    {
+        return getDistance(a, b);
+    }
+};
+
+struct ManhattanHeuristic
+{
+    int operator()(const Point &a, const Point &b) const
+    {
+        return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+    }
+};
+
+// max(dx, dy) + (sqrt(2) - 1) * min(dx, dy), the cost of an 8-connected move sequence
+struct OctileHeuristic
+{
+    int operator()(const Point &a, const Point &b) const
+    {
+        int dx = std::abs(a.x - b.x);
+        int dy = std::abs(a.y - b.y);
+        // 106 / 256 is just below sqrt(2) - 1
+        return std::max(dx, dy) + (std::min(dx, dy) * 106 >> 8);
+    }
+};
+
+// Lower bound of the euclidean distance without sqrt:
+// max(dx, dy, (dx + dy) / sqrt(2)) <= sqrt(dx^2 + dy^2).
+struct EuclideanBoundHeuristic
+{
+    int operator()(const Point &a, const Point &b) const
+    {
+        int dx = std::abs(a.x - b.x);
+        int dy = std::abs(a.y - b.y);
+        // 181 / 256 is just below 1 / sqrt(2)
+        int diagonal = static_cast<int>((static_cast<int64_t>(dx) + dy) * 181 >> 8);
+        return std::max(std::max(dx, dy), diagonal);
+    }
+};
+
+// max(dx, dy), the largest lower bound of the euclidean distance that is exact
+// in integers. The sqrt-based policies round down, which can break the triangle
+// inequality by one unit; planners that reuse keys across changes (D* Lite)
+// need it to hold exactly. Not a HeuristicModes entry.
+struct ChebyshevHeuristic
+{
+    int operator()(const Point &a, const Point &b) const
+    {
+        return std::max(std::abs(a.x - b.x), std::abs(a.y - b.y));
+    }
+};
+
+// Binds a metric to a graph and a target, giving the h(vertex) the searches call.
+template <typename G, typename Metric>
+struct PointHeuristic
+{
+    const G *graph;
+    Metric metric;
+    Point target;
+
+    int operator()(int vertex) const
+    {
+        return metric(graph->getCoordinate(vertex), target);
+    }
+};
+
+template <typename G, typename Metric>
+PointHeuristic<G, Metric> makePointHeuristic(const G &g, Metric metric, int target)
+{
+    return {&g, metric, g.getCoordinate(target)};
+}
+
+// Maps a runtime HeuristicModes value onto its policy: calls f(policy) once, so
+// the code inside f is compiled separately for every mode.
+template <typename F>
+auto dispatchHeuristic(HeuristicModes mode, F &&f) -> decltype(f(ZeroHeuristic()))
+{
+    switch (mode)
+    {
+    case HeuristicModes::zero:
+        return f(ZeroHeuristic());
+    case HeuristicModes::euclidean:
+        return f(EuclideanHeuristic());
+    case HeuristicModes::xDifference:
+        return f(XDifferenceHeuristic());
+    case HeuristicModes::yDifference:
+        return f(YDifferenceHeuristic());
+    case HeuristicModes::manhattan:
+        return f(ManhattanHeuristic());
+    case HeuristicModes::octile:
+        return f(OctileHeuristic());
+    case HeuristicModes::euclideanBound:
+        return f(EuclideanBoundHeuristic());
+    default:
+        throw std::runtime_error("Incorrect heuristic");
+    }
+}
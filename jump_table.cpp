@@ -0,0 +1,174 @@
+#include "jump_table.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace
+{
+    int sign(int value)
+    {
+        return (value > 0) - (value < 0);
+    }
+}
+
+JumpTable JumpTable::build(const GridGraph &g)
+{
+    auto begin = std::chrono::steady_clock::now();
+
+    JumpTable result;
+    result.width = g.getWidth();
+    result.height = g.getHeight();
+    result.distances.assign(static_cast<size_t>(g.getVertexCount()) * 8, 0);
+
+    const int width = g.getWidth();
+    const int height = g.getHeight();
+
+    // Each entry follows from the one of the next cell in the same direction,
+    // so every direction is one sweep against it. Diagonals look at the
+    // straight entries, which therefore come first.
+    for (int direction = 0; direction < 8; direction++)
+    {
+        const int dx = GRID_DX[direction];
+        const int dy = GRID_DY[direction];
+        const bool diagonal = direction >= 4;
+
+        for (int row = 0; row < height; row++)
+        {
+            const int y = dy > 0 ? height - 1 - row : row;
+            for (int column = 0; column < width; column++)
+            {
+                const int x = dx > 0 ? width - 1 - column : column;
+                if (!g.isWalkable(x, y))
+                    continue;
+
+                const int nx = x + dx;
+                const int ny = y + dy;
+                bool canMove = g.isWalkable(nx, ny);
+                if (diagonal)
+                    canMove = canMove && g.isWalkable(nx, y) && g.isWalkable(x, ny);
+
+                int32_t &distance = result.distances[static_cast<size_t>(g.getVertex(x, y)) * 8 + direction];
+                if (!canMove)
+                {
+                    distance = 0;
+                    continue;
+                }
+
+                const size_t next = static_cast<size_t>(g.getVertex(nx, ny)) * 8;
+                bool jumpPoint;
+                if (diagonal)
+                    jumpPoint = result.distances[next + getGridDirection(dx, 0)] > 0 || result.distances[next + getGridDirection(0, dy)] > 0;
+                else
+                    jumpPoint = g.hasForcedNeighbor(nx, ny, dx, dy);
+
+                int32_t nextDistance = result.distances[next + direction];
+                if (jumpPoint)
+                    distance = 1;
+                else
+                    distance = nextDistance > 0 ? nextDistance + 1 : nextDistance - 1;
+            }
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    result.preprocessingMilliseconds = std::chrono::duration<double, std::milli>(end - begin).count();
+
+    return result;
+}
+
+bool JumpTable::query(const GridGraph &g, int start, int finish, SearchWorkspace<> &workspace) const
+{
+    if (g.getWidth() != width || g.getHeight() != height)
+        throw std::invalid_argument("Jump table was built for another grid");
+
+    workspace.reset(g.getVertexCount());
+    BinaryHeap &openSet = workspace.openSet;
+
+    if (g.isBlocked(start) || g.isBlocked(finish))
+        return false;
+
+    auto heuristic = makePointHeuristic(g, OctileHeuristic(), finish);
+    const int finishX = finish % width;
+    const int finishY = finish / width;
+
+    workspace.setScore(start, 0, -1);
+    workspace.push(start, heuristic(start));
+    ASTAR_STATS(workspace.stats.heuristicEvaluations++);
+
+    while (!openSet.empty())
+    {
+        int currentVertex = workspace.settle();
+
+        if (currentVertex == finish)
+        {
+            g.unpackJumpPath(finish, workspace);
+            return true;
+        }
+
+        const int x = currentVertex % width;
+        const int y = currentVertex / width;
+        const int toFinishX = finishX - x;
+        const int toFinishY = finishY - y;
+        const int currentGScore = workspace.getGScore(currentVertex);
+
+        int dx = 0, dy = 0;
+        int parent = workspace.getCameFrom(currentVertex);
+        if (parent != -1)
+        {
+            dx = sign(x - static_cast<int>(parent % width));
+            dy = sign(y - static_cast<int>(parent / width));
+        }
+
+        unsigned directions = g.getJumpDirections(x, y, dx, dy);
+        for (int direction = 0; direction < 8; direction++)
+        {
+            if (!(directions >> direction & 1))
+                continue;
+
+            const int moveX = GRID_DX[direction];
+            const int moveY = GRID_DY[direction];
+            const int distance = getDistance(currentVertex, direction);
+            const int reach = std::abs(distance);
+
+            int steps = 0;
+            if (direction < 4)
+            {
+                // the finish lies straight ahead before the wall or the jump point
+                bool ahead = moveX != 0 ? toFinishY == 0 && sign(toFinishX) == moveX
+                                        : toFinishX == 0 && sign(toFinishY) == moveY;
+                int finishSteps = std::abs(toFinishX) + std::abs(toFinishY);
+                if (ahead && finishSteps <= reach)
+                    steps = finishSteps;
+                else if (distance > 0)
+                    steps = distance;
+            }
+            else
+            {
+                // stop where the diagonal crosses the row or column of the finish
+                bool ahead = sign(toFinishX) == moveX && sign(toFinishY) == moveY;
+                int crossing = std::min(std::abs(toFinishX), std::abs(toFinishY));
+                if (ahead && crossing <= reach)
+                    steps = crossing;
+                else if (distance > 0)
+                    steps = distance;
+            }
+
+            if (steps == 0)
+                continue;
+
+            int successor = g.getVertex(x + moveX * steps, y + moveY * steps);
+            int newGScore = currentGScore + steps * (direction < 4 ? GRID_STRAIGHT_COST : GRID_DIAGONAL_COST);
+            ASTAR_STATS(workspace.stats.relaxed++);
+
+            if (newGScore < workspace.getGScore(successor))
+            {
+                workspace.setScore(successor, newGScore, currentVertex);
+                workspace.push(successor, newGScore + heuristic(successor));
+                ASTAR_STATS(workspace.stats.heuristicEvaluations++);
+            }
+        }
+    }
+
+    return false;
+}
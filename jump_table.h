@@ -0,0 +1,48 @@
+#pragma once
+
+#include "grid_graph.h"
+#include "search_workspace.h"
+#include <cstdint>
+#include <vector>
+
+// Precomputed jump distances for JPS+.
+//
+// For every free cell and each of the 8 moves the table stores how far the
+// online Jump Point Search would scan: a positive value is the number of steps
+// to the next jump point, zero or a negative value is minus the number of
+// steps to the wall. A query then reads one entry per move instead of walking
+// the grid, and only has to check whether the finish lies on the way.
+//
+// The table is a snapshot; rebuild it after changing the grid.
+class JumpTable
+{
+private:
+    uint32_t width = 0;
+    uint32_t height = 0;
+    // distances[vertex * 8 + direction], directions as in GRID_DX / GRID_DY
+    std::vector<int32_t> distances;
+    double preprocessingMilliseconds = 0;
+
+public:
+    static JumpTable build(const GridGraph &g);
+
+    int getDistance(int vertex, int direction) const
+    {
+        return distances[static_cast<size_t>(vertex) * 8 + direction];
+    }
+
+    size_t getTableBytes() const
+    {
+        return distances.size() * sizeof(int32_t);
+    }
+
+    double getPreprocessingMilliseconds() const
+    {
+        return preprocessingMilliseconds;
+    }
+
+    // JPS+ search on "g", which must be the grid the table was built from.
+    // Leaves the cell by cell path in workspace.path and returns false when
+    // "finish" is unreachable.
+    bool query(const GridGraph &g, int start, int finish, SearchWorkspace<> &workspace) const;
+};
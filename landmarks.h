@@ -0,0 +1,174 @@
+#pragma once
+
+#include "delta_stepping.h"
+#include "search.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// table entry of a vertex the landmark cannot reach
+const uint32_t LANDMARK_UNREACHABLE = UINT32_MAX;
+
+// Landmark distance tables for the ALT (A*, landmarks, triangle inequality)
+// heuristic.
+//
+// For a landmark L the triangle inequality gives |d(L, t) - d(L, v)| <= d(v, t),
+// and the heuristic takes the largest of these bounds over all landmarks. Unlike
+// the coordinate heuristics it follows the actual edge weights, so it stays
+// tight when weights differ from straight-line distances.
+//
+// The tables are stored vertex-major, so one evaluation reads the K distances of
+// a vertex from a single contiguous row. The graph must be undirected.
+class Landmarks
+{
+private:
+    uint32_t landmarkCount = 0;
+    std::vector<int> landmarks;
+    // distances[vertex * landmarkCount + i] is the distance from landmark i
+    std::vector<uint32_t> distances;
+    double preprocessingMilliseconds = 0;
+
+    // "shortestPaths(start, row)" fills row with the distances from start
+    template <typename G, typename ShortestPaths>
+    static Landmarks select(const G &g, unsigned count, ShortestPaths shortestPaths);
+
+public:
+    // Picks up to "count" landmarks by farthest-point selection, each one as far
+    // as possible from those already chosen, then stores their distance tables.
+    template <typename G>
+    static Landmarks build(const G &g, unsigned count);
+
+    // the same, with every distance table computed by parallel delta-stepping
+    // on the workers of "pool"
+    template <typename G>
+    static Landmarks build(const G &g, unsigned count, ThreadPool &pool);
+
+    unsigned getLandmarkCount() const
+    {
+        return landmarkCount;
+    }
+
+    int getLandmark(unsigned index) const
+    {
+        return landmarks[index];
+    }
+
+    size_t getTableBytes() const
+    {
+        return distances.size() * sizeof(uint32_t);
+    }
+
+    double getPreprocessingMilliseconds() const
+    {
+        return preprocessingMilliseconds;
+    }
+
+    // lower bound of the distance between "vertex" and "target"
+    int lowerBound(int vertex, int target) const
+    {
+        const uint32_t *from = &distances[static_cast<size_t>(vertex) * landmarkCount];
+        const uint32_t *to = &distances[static_cast<size_t>(target) * landmarkCount];
+
+        int64_t best = 0;
+        for (uint32_t i = 0; i < landmarkCount; i++)
+        {
+            // a landmark that misses either vertex says nothing about them
+            if (from[i] == LANDMARK_UNREACHABLE || to[i] == LANDMARK_UNREACHABLE)
+                continue;
+            int64_t bound = std::abs(static_cast<int64_t>(to[i]) - from[i]);
+            best = std::max(best, bound);
+        }
+        return static_cast<int>(best);
+    }
+};
+
+// h(vertex) for the searches, bound to one target
+struct AltHeuristic
+{
+    const Landmarks *landmarks;
+    int target;
+
+    int operator()(int vertex) const
+    {
+        return landmarks->lowerBound(vertex, target);
+    }
+};
+
+template <typename G>
+Landmarks Landmarks::build(const G &g, unsigned count)
+{
+    return select(g, count, [&](int start, int *row)
+    {
+        search::djikstra(g, start, row);
+    });
+}
+
+template <typename G>
+Landmarks Landmarks::build(const G &g, unsigned count, ThreadPool &pool)
+{
+    return select(g, count, [&](int start, int *row)
+    {
+        search::deltaStepping(g, start, row, pool);
+    });
+}
+
+template <typename G, typename ShortestPaths>
+Landmarks Landmarks::select(const G &g, unsigned count, ShortestPaths shortestPaths)
+{
+    auto begin = std::chrono::steady_clock::now();
+
+    const uint32_t vertexCount = g.getVertexCount();
+    Landmarks result;
+
+    if (vertexCount == 0)
+        return result;
+
+    count = std::min(count, vertexCount);
+    result.landmarkCount = count;
+    result.distances.assign(static_cast<size_t>(vertexCount) * count, LANDMARK_UNREACHABLE);
+
+    // distance from each vertex to its closest landmark so far,
+    // the next landmark is the vertex where this is largest
+    std::vector<int64_t> closest(vertexCount, search::INF);
+    std::vector<int> row(vertexCount);
+
+    // start from the vertex farthest from vertex 0
+    shortestPaths(0, row.data());
+    int next = 0;
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        if (row[v] != search::INF && row[v] > row[next])
+            next = v;
+    }
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        result.landmarks.push_back(next);
+        shortestPaths(next, row.data());
+
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            if (row[v] != search::INF)
+            {
+                result.distances[static_cast<size_t>(v) * count + i] = row[v];
+                closest[v] = std::min<int64_t>(closest[v], row[v]);
+            }
+        }
+
+        // vertices no landmark reaches yet win, which spreads landmarks over
+        // every connected component
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            if (closest[v] > closest[next])
+                next = v;
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    result.preprocessingMilliseconds = std::chrono::duration<double, std::milli>(end - begin).count();
+
+    return result;
+}
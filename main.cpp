@@ -1,33 +1,20 @@
-#include "graph.h"
+#include "contraction_hierarchy.h"
+#include "dstar_lite.h"
+#include "dynamic_graph.h"
+#include "grid_graph.h"
 #include "helper.h"
+#include "jump_table.h"
+#include "landmarks.h"
+#include "mapped_graph.h"
+#include "visualization.h"
 #include <SDL.h>
-#include <chrono>
 #include <ctime>
+#include <fstream>
 #include <iostream>
+#include <memory>
 
 using namespace std;
 
-class Timer
-{
-private:
-	chrono::high_resolution_clock::time_point m_start;
-
-public:
-	void start()
-	{
-		m_start = chrono::high_resolution_clock::now();
-	}
-	uint64_t tick()
-	{
-		auto end = chrono::high_resolution_clock::now();
-
-		auto duration = chrono::duration_cast<chrono::microseconds>(end - m_start).count();
-		m_start = end;
-
-		return duration;
-	}
-};
-
 void handleInput();
 
 bool running = true;
@@ -44,16 +31,85 @@ int startVertexAStar = -1;
 
 vector<int> shortestPath;
 
+// settled vertices of the last query in order, drawn under the path
+vector<int> expandedVertices;
+// last graph query, 'h' replays it with the next heuristic and 'a' with the
+// next algorithm
+int lastStart = -1;
+int lastFinish = -1;
+HeuristicModes traceHeuristic = HeuristicModes::euclidean;
+
+// what the graph and the grid queries run, 'bench' compares their timings
+enum class GraphAlgorithm
+{
+	astar,
+	alt,
+	bidirectional,
+	ch,
+	count
+};
+GraphAlgorithm graphAlgorithm = GraphAlgorithm::astar;
+
+enum class GridAlgorithm
+{
+	astar,
+	jps,
+	jumpTable,
+	count
+};
+GridAlgorithm gridAlgorithm = GridAlgorithm::jps;
+
+// last grid query, -1 once the grid changed
+int lastGridStart = -1;
+int lastGridFinish = -1;
+const char *traceFileName = "trace.csv";
+
+// incremental planner for the last query, built on the first repair and dropped
+// whenever the query or the graph changes
+unique_ptr<DStarLite<>> planner;
+const int repairWeightFactor = 3;
+
+// preprocessing of the graph, built by the first ALT or CH query and dropped
+// by graphChanged
+unique_ptr<Landmarks> landmarks;
+unique_ptr<ContractionHierarchy> hierarchy;
+
 uint8_t density = 10;
 
+const unsigned landmarkCount = 4;
+
+// grid mode shows the occupancy grid instead of the graph
+bool inGridMode = false;
+const int gridCellSize = 16;
+const int gridDensity = 25;
+
+const char *graphFileName = "graph.bin";
+
+ThreadPool pool;
+
 bool addVertexEvent(const SDL_Event &e);
 bool addEdgeEvent(const SDL_Event &e);
 void handleKeyboardInput(const SDL_Event &e);
 void handleMouseButtonDown(const SDL_Event &e);
 bool addVertexToAStarEvent(const SDL_Event &e);
 void performAStar(uint32_t end);
-
-Graph<graphSize> g;
+void graphChanged();
+void gridChanged();
+bool toggleCellEvent(const SDL_Event &e);
+void performGridSearch(uint32_t end);
+void runQuery();
+void runGridQuery();
+void nextTraceHeuristic();
+void nextAlgorithm();
+void exportTrace();
+void repairPath();
+void saveGraphFile();
+void loadGraphFile();
+
+DynamicGraph g;
+GridGraph grid(helper::getWidth() / gridCellSize, helper::getHeight() / gridCellSize, gridCellSize);
+// JPS+ table of the grid, rebuilt by gridChanged
+JumpTable jumpTable = JumpTable::build(grid);
 
 int main(int argc, char *args[])
 {
@@ -69,8 +125,18 @@ int main(int argc, char *args[])
 		helper::clear();
 		helper::setColor(0xFF, 0x00, 0x00);
 
-		g.draw();
-		g.drawPath(shortestPath);
+		if (inGridMode)
+		{
+			visualization::draw(grid);
+			visualization::drawExpanded(grid, expandedVertices);
+			visualization::drawPath(grid, shortestPath);
+		}
+		else
+		{
+			visualization::draw(g);
+			visualization::drawExpanded(g, expandedVertices);
+			visualization::drawPath(g, shortestPath);
+		}
 
 		helper::present();
 		SDL_Delay(10);
@@ -80,38 +146,325 @@ int main(int argc, char *args[])
 	return 0;
 }
 
+// drops what was preprocessed from the graph; call after every change to it
+void graphChanged()
+{
+	landmarks.reset();
+	hierarchy.reset();
+}
+
 void performAStar(uint32_t end)
 {
-	try
+	lastStart = startVertexAStar;
+	lastFinish = end;
+	planner.reset();
+	startVertexAStar = -1;
+	runQuery();
+}
+
+const char *getAlgorithmName(GraphAlgorithm algorithm)
+{
+	switch (algorithm)
 	{
-		shortestPath = g.aStarSearch(startVertexAStar, end);
+	case GraphAlgorithm::alt:
+		return "ALT";
+	case GraphAlgorithm::bidirectional:
+		return "Bidirectional A*";
+	case GraphAlgorithm::ch:
+		return "CH";
+	default:
+		return "A*";
 	}
-	catch (...)
+}
+
+const char *getAlgorithmName(GridAlgorithm algorithm)
+{
+	switch (algorithm)
 	{
-		startVertexAStar = -1;
+	case GridAlgorithm::jps:
+		return "JPS";
+	case GridAlgorithm::jumpTable:
+		return "JPS+";
+	default:
+		return "Grid A*";
+	}
+}
+
+// Reruns the last query with graphAlgorithm (A* with traceHeuristic), keeping
+// the path and the settled vertices in order. The bidirectional searches trace
+// the forward side first.
+void runQuery()
+{
+	if (lastStart == -1)
+		return;
+
+	bool found = false;
+	size_t settled = 0;
+	SearchStats stats;
+
+	if (graphAlgorithm == GraphAlgorithm::astar || graphAlgorithm == GraphAlgorithm::alt)
+	{
+		SearchWorkspace<> workspace;
+		workspace.trace = &expandedVertices;
+
+		if (graphAlgorithm == GraphAlgorithm::astar)
+		{
+			found = search::aStarSearch(g, lastStart, lastFinish, traceHeuristic, workspace);
+		}
+		else
+		{
+			if (!landmarks)
+			{
+				landmarks.reset(new Landmarks(Landmarks::build(g, landmarkCount)));
+				cout << "ALT: " << landmarks->getLandmarkCount() << " landmarks in "
+					 << landmarks->getPreprocessingMilliseconds() << " ms\n";
+			}
+			found = search::aStarSearch(g, lastStart, lastFinish, AltHeuristic{landmarks.get(), lastFinish}, workspace);
+		}
+		shortestPath = workspace.path;
+		settled = workspace.settled;
+		stats = workspace.stats;
+	}
+	else
+	{
+		BidirectionalWorkspace<> workspace;
+		vector<int> backwardTrace;
+		workspace.forward.trace = &expandedVertices;
+		workspace.backward.trace = &backwardTrace;
+
+		if (graphAlgorithm == GraphAlgorithm::bidirectional)
+		{
+			found = search::bidirectionalAStarSearch(g, lastStart, lastFinish, HeuristicModes::euclidean, workspace);
+		}
+		else
+		{
+			if (!hierarchy)
+			{
+				hierarchy.reset(new ContractionHierarchy(ContractionHierarchy::build(g, pool)));
+				cout << "CH: " << hierarchy->getShortcutCount() << " shortcuts in "
+					 << hierarchy->getPreprocessingMilliseconds() << " ms\n";
+			}
+			found = hierarchy->query(lastStart, lastFinish, workspace) != search::INF;
+		}
+		expandedVertices.insert(expandedVertices.end(), backwardTrace.begin(), backwardTrace.end());
+		shortestPath = workspace.path;
+		settled = workspace.forward.settled + workspace.backward.settled;
+		stats = workspace.forward.stats;
+		stats += workspace.backward.stats;
+	}
+
+	if (!found)
+	{
+		shortestPath.clear();
 		cout << "No path\n";
 		return;
 	}
-	Timer timer;
-	timer.start();
 
-	Graph<graphSize>::setHeuristic(HeuristicModes::euclidean);
-	g.aStarSearch(startVertexAStar, end);
-	cout << "Euclidean: " << timer.tick() << "\n";
+	cout << getAlgorithmName(graphAlgorithm);
+	if (graphAlgorithm == GraphAlgorithm::astar)
+		cout << " " << getHeuristicName(traceHeuristic);
+	cout << ": settled " << settled;
+#ifdef ASTAR_ENABLE_STATS
+	cout << ", " << stats;
+#endif
+	cout << "\n";
+}
+
+void nextTraceHeuristic()
+{
+	const HeuristicModes order[] = {HeuristicModes::zero, HeuristicModes::euclidean, HeuristicModes::euclideanBound,
+									HeuristicModes::xDifference, HeuristicModes::yDifference};
+	const int count = sizeof(order) / sizeof(order[0]);
+
+	int next = 0;
+	for (int i = 0; i < count; i++)
+	{
+		if (order[i] == traceHeuristic)
+			next = (i + 1) % count;
+	}
+	traceHeuristic = order[next];
+	runQuery();
+}
+
+// switches the algorithm of the current mode and replays its last query
+void nextAlgorithm()
+{
+	if (inGridMode)
+	{
+		int next = (static_cast<int>(gridAlgorithm) + 1) % static_cast<int>(GridAlgorithm::count);
+		gridAlgorithm = static_cast<GridAlgorithm>(next);
+		cout << "Grid queries use " << getAlgorithmName(gridAlgorithm) << "\n";
+		runGridQuery();
+	}
+	else
+	{
+		int next = (static_cast<int>(graphAlgorithm) + 1) % static_cast<int>(GraphAlgorithm::count);
+		graphAlgorithm = static_cast<GraphAlgorithm>(next);
+		cout << "Graph queries use " << getAlgorithmName(graphAlgorithm) << "\n";
+		runQuery();
+	}
+}
+
+void exportTrace()
+{
+	ofstream file(traceFileName);
+	if (inGridMode)
+		search::writeTrace(file, grid, expandedVertices);
+	else
+		search::writeTrace(file, g, expandedVertices);
+
+	if (file)
+		cout << "Wrote " << expandedVertices.size() << " expanded vertices to " << traceFileName << "\n";
+	else
+		cout << "Cannot write " << traceFileName << "\n";
+}
+
+// makes a random edge of the current path more expensive and repairs the path
+// with D* Lite instead of searching again
+void repairPath()
+{
+	if (lastStart == -1)
+		return;
+
+	if (!planner)
+	{
+		planner.reset(new DStarLite<>(g));
+		planner->plan(lastStart, lastFinish);
+		cout << "D* Lite plan: expanded " << planner->getLastExpansions() << "\n";
+	}
+
+	const vector<int> &path = planner->getPath();
+	if (path.size() < 2)
+		return;
+
+	size_t index = rand() % (path.size() - 1);
+	uint32_t from = path[index];
+	uint32_t to = path[index + 1];
+	int weight = getDistance(g.getCoordinate(from), g.getCoordinate(to)) * repairWeightFactor;
 
-	Graph<graphSize>::setHeuristic(HeuristicModes::zero);
-	g.aStarSearch(startVertexAStar, end);
-	cout << "Djikstra : " << timer.tick() << "\n";
+	g.addEdge(from, to, weight);
+	graphChanged();
+	int distance = planner->applyChanges({{from, to, weight}, {to, from, weight}});
 
-	Graph<graphSize>::setHeuristic(HeuristicModes::xDifference);
-	g.aStarSearch(startVertexAStar, end);
-	cout << "X difference: " << timer.tick() << "\n";
+	DStarLite<> replan(g);
+	replan.plan(lastStart, lastFinish);
+	cout << "Repair " << g.getVertexName(from) << "-" << g.getVertexName(to) << " to " << weight << ": distance "
+		 << distance << ", expanded " << planner->getLastExpansions() << " (full replan " << replan.getLastExpansions() << ")\n";
 
-	Graph<graphSize>::setHeuristic(HeuristicModes::yDifference);
-	g.aStarSearch(startVertexAStar, end);
-	cout << "Y difference: " << timer.tick() << "\n";
+	shortestPath = planner->getPath();
+	expandedVertices.clear();
+}
+
+// rebuilds the jump table after every change to the grid
+void gridChanged()
+{
+	jumpTable = JumpTable::build(grid);
+	lastGridStart = -1;
+}
 
+void performGridSearch(uint32_t end)
+{
+	lastGridStart = startVertexAStar;
+	lastGridFinish = end;
 	startVertexAStar = -1;
+	runGridQuery();
+}
+
+// reruns the last grid query with gridAlgorithm, the trace of the jump point
+// searches shows the jump points
+void runGridQuery()
+{
+	if (lastGridStart == -1)
+		return;
+
+	SearchWorkspace<> workspace;
+	workspace.trace = &expandedVertices;
+	bool found = false;
+
+	switch (gridAlgorithm)
+	{
+	case GridAlgorithm::astar:
+		found = grid.aStarSearch(lastGridStart, lastGridFinish, workspace);
+		break;
+	case GridAlgorithm::jps:
+		found = grid.jumpPointSearch(lastGridStart, lastGridFinish, workspace);
+		break;
+	default:
+		found = jumpTable.query(grid, lastGridStart, lastGridFinish, workspace);
+		break;
+	}
+
+	if (!found)
+	{
+		shortestPath.clear();
+		cout << "No path\n";
+		return;
+	}
+	shortestPath = workspace.path;
+	cout << getAlgorithmName(gridAlgorithm) << ": settled " << workspace.settled << "\n";
+}
+
+void saveGraphFile()
+{
+	try
+	{
+		graphfile::save(g, graphFileName);
+		cout << "Saved " << g.getVertexCount() << " vertices to " << graphFileName << "\n";
+	}
+	catch (const exception &e)
+	{
+		cout << e.what() << "\n";
+	}
+}
+
+void loadGraphFile()
+{
+	try
+	{
+		// the mapped graph is read-only, copy it into an editable one
+		MappedGraph file(graphFileName);
+		DynamicGraph loaded;
+		loaded.reserve(file.getVertexCount());
+
+		for (uint32_t i = 0; i < file.getVertexCount(); i++)
+		{
+			loaded.addVertex(file.getVertexName(i), file.getCoordinate(i));
+		}
+		for (uint32_t i = 0; i < file.getVertexCount(); i++)
+		{
+			// the file stores two-way edges as two arcs of the same weight; keep
+			// the stored weights and restore one-way arcs as such
+			file.forEachNeighbor(i, [&](int neighbor, int weight)
+			{
+				bool twoWay = false;
+				file.forEachNeighbor(neighbor, [&](int back, int backWeight)
+				{
+					if (back == static_cast<int>(i) && backWeight == weight)
+						twoWay = true;
+				});
+
+				if (twoWay)
+					loaded.addEdge(i, neighbor, weight);
+				else
+					loaded.addArc(i, neighbor, weight);
+			});
+		}
+
+		g = move(loaded);
+		addedVertices = g.getVertexCount();
+		lastStart = -1;
+		planner.reset();
+		graphChanged();
+		shortestPath.clear();
+		expandedVertices.clear();
+		firstVertex = -1;
+		startVertexAStar = -1;
+		cout << "Loaded " << g.getVertexCount() << " vertices from " << graphFileName << "\n";
+	}
+	catch (const exception &e)
+	{
+		cout << e.what() << "\n";
+	}
 }
 
 void handleInput()
@@ -138,7 +491,11 @@ void handleInput()
 
 void handleMouseButtonDown(const SDL_Event &e)
 {
-	if (!inAStarMode)
+	if (inGridMode && !inAStarMode)
+	{
+		toggleCellEvent(e);
+	}
+	else if (!inAStarMode)
 	{
 		bool addedVertex = addVertexEvent(e);
 		if (!addedVertex)
@@ -153,12 +510,13 @@ void handleMouseButtonDown(const SDL_Event &e)
 bool addVertexToAStarEvent(const SDL_Event &e)
 {
 	shortestPath.clear();
+	expandedVertices.clear();
 
 	Point pos = {e.button.x, e.button.y};
 
-	int vertex = g.getNearbyVertex(pos);
+	int vertex = inGridMode ? grid.getNearbyVertex(pos) : g.getNearbyVertex(pos);
 
-	if (vertex == -1)
+	if (vertex == -1 || (inGridMode && grid.isBlocked(vertex)))
 		return false;
 
 	if (startVertexAStar == -1)
@@ -167,7 +525,10 @@ bool addVertexToAStarEvent(const SDL_Event &e)
 		return false;
 	}
 
-	performAStar(vertex);
+	if (inGridMode)
+		performGridSearch(vertex);
+	else
+		performAStar(vertex);
 
 	return true;
 }
@@ -178,10 +539,22 @@ void handleKeyboardInput(const SDL_Event &e)
 	{
 	case SDLK_c:
 		// clear graph
-		g = Graph<graphSize>();
+		if (inGridMode)
+		{
+			grid = GridGraph(grid.getWidth(), grid.getHeight(), gridCellSize);
+			gridChanged();
+		}
+		else
+		{
+			g = DynamicGraph();
+			addedVertices = 0;
+			lastStart = -1;
+			planner.reset();
+			graphChanged();
+		}
 		shortestPath.clear();
+		expandedVertices.clear();
 		firstVertex = -1;
-		addedVertices = 0;
 		startVertexAStar = -1;
 		break;
 	case SDLK_s:
@@ -192,10 +565,60 @@ void handleKeyboardInput(const SDL_Event &e)
 		break;
 	case SDLK_q:
 		break;
+	case SDLK_h:
+		// replay the last query with the next heuristic
+		if (!inGridMode)
+			nextTraceHeuristic();
+		break;
+	case SDLK_e:
+		exportTrace();
+		break;
+	case SDLK_u:
+		// raise the weight of an edge on the path and repair it
+		if (!inGridMode)
+			repairPath();
+		break;
+	case SDLK_w:
+		saveGraphFile();
+		break;
+	case SDLK_l:
+		loadGraphFile();
+		break;
+	case SDLK_a:
+		// replay the last query with the next algorithm
+		nextAlgorithm();
+		break;
+	case SDLK_g:
+		// switch between the graph and the grid
+		inGridMode = !inGridMode;
+		shortestPath.clear();
+		expandedVertices.clear();
+		firstVertex = -1;
+		startVertexAStar = -1;
+		break;
 	case SDLK_r:
-		g = Graph<graphSize>::getRandomGraph(density);
-		addedVertices = graphSize;
+		if (inGridMode)
+		{
+			grid = GridGraph::getRandomGrid(grid.getWidth(), grid.getHeight(), gridDensity, gridCellSize);
+			gridChanged();
+		}
+		else
+		{
+			try
+			{
+				g = DynamicGraph::getRandomGraph(graphSize, density, helper::getWidth(), helper::getHeight());
+				addedVertices = graphSize;
+				lastStart = -1;
+				planner.reset();
+				graphChanged();
+			}
+			catch (const exception &e)
+			{
+				cout << "Could not generate a graph: " << e.what() << "\n";
+			}
+		}
 		shortestPath.clear();
+		expandedVertices.clear();
 		firstVertex = -1;
 		startVertexAStar = -1;
 		break;
@@ -215,6 +638,7 @@ bool addVertexEvent(const SDL_Event &e)
 	char letter = 'A' + addedVertices;
 	g.addVertex(letter, pos);
 	addedVertices++;
+	graphChanged();
 
 	firstVertex = -1;
 
@@ -237,6 +661,24 @@ bool addEdgeEvent(const SDL_Event &e)
 	{
 		g.addEdge(firstVertex, vertex);
 		firstVertex = -1;
+		planner.reset();
+		graphChanged();
 	}
 	return true;
 }
+
+bool toggleCellEvent(const SDL_Event &e)
+{
+	Point pos = {e.button.x, e.button.y};
+
+	int cell = grid.getNearbyVertex(pos);
+	if (cell == -1)
+		return false;
+
+	grid.setBlocked(cell, !grid.isBlocked(cell));
+	gridChanged();
+	shortestPath.clear();
+	expandedVertices.clear();
+
+	return true;
+}
@@ -0,0 +1,189 @@
+#include "mapped_graph.h"
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+HeuristicModes MappedGraph::heuristicMode = HeuristicModes::euclidean;
+
+namespace
+{
+    // whether [start, start + length) lies in the file and is aligned
+    bool sectionFits(uint64_t start, uint64_t length, uint64_t fileSize)
+    {
+        return start % GRAPH_FILE_ALIGNMENT == 0 && start <= fileSize && length <= fileSize - start;
+    }
+}
+
+MappedGraph::MappedGraph(const std::string &path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Cannot open graph file " + path);
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        unmap();
+        throw std::runtime_error("Cannot map graph file " + path);
+    }
+    size = fileSize.QuadPart;
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle)
+        data = static_cast<const char *>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!data)
+    {
+        unmap();
+        throw std::runtime_error("Cannot map graph file " + path);
+    }
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file == -1)
+        throw std::runtime_error("Cannot open graph file " + path);
+
+    struct stat status;
+    if (fstat(file, &status) == -1 || status.st_size == 0)
+    {
+        close(file);
+        throw std::runtime_error("Cannot map graph file " + path);
+    }
+    size = status.st_size;
+
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+    // the mapping keeps its own reference to the file
+    close(file);
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error("Cannot map graph file " + path);
+    data = static_cast<const char *>(mapping);
+#endif
+
+    GraphFileHeader header;
+    if (size < sizeof(header))
+    {
+        unmap();
+        throw std::runtime_error("Graph file " + path + " is truncated");
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) != 0)
+    {
+        unmap();
+        throw std::runtime_error(path + " is not a graph file");
+    }
+    if (header.version != GRAPH_FILE_VERSION || header.byteOrder != GRAPH_FILE_BYTE_ORDER)
+    {
+        unmap();
+        throw std::runtime_error("Graph file " + path + " has an unsupported version or byte order");
+    }
+
+    const uint64_t n = header.vertexCount;
+    const uint64_t m = header.arcCount;
+    bool fits = header.fileSize == size && n < UINT32_MAX && m < (UINT64_MAX >> 3) &&
+                sectionFits(header.offsetsStart, (n + 1) * sizeof(uint64_t), size) &&
+                sectionFits(header.neighborsStart, m * sizeof(uint32_t), size) &&
+                sectionFits(header.weightsStart, m * sizeof(int32_t), size) &&
+                sectionFits(header.coordinatesStart, n * sizeof(Point), size) &&
+                sectionFits(header.namesStart, n, size);
+    if (!fits)
+    {
+        unmap();
+        throw std::runtime_error("Graph file " + path + " is truncated or corrupt");
+    }
+
+    vertexCount = n;
+    arcCount = m;
+    offsets = reinterpret_cast<const uint64_t *>(data + header.offsetsStart);
+    neighbors = reinterpret_cast<const uint32_t *>(data + header.neighborsStart);
+    weights = reinterpret_cast<const int32_t *>(data + header.weightsStart);
+    coordinates = reinterpret_cast<const Point *>(data + header.coordinatesStart);
+    vertexNames = data + header.namesStart;
+}
+
+MappedGraph::~MappedGraph()
+{
+    unmap();
+}
+
+void MappedGraph::unmap()
+{
+#ifdef _WIN32
+    if (data)
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle)
+        CloseHandle(fileHandle);
+    fileHandle = mappingHandle = nullptr;
+#else
+    if (data)
+        munmap(const_cast<char *>(data), size);
+#endif
+    data = nullptr;
+}
+
+void MappedGraph::setHeuristic(HeuristicModes heuristic)
+{
+    heuristicMode = heuristic;
+}
+
+uint64_t MappedGraph::getFileSize() const
+{
+    return size;
+}
+
+char MappedGraph::getVertexName(int vertex) const
+{
+    return vertexNames[vertex];
+}
+
+uint32_t MappedGraph::getVertexCount() const
+{
+    return vertexCount;
+}
+
+uint64_t MappedGraph::getEdgeCount() const
+{
+    return arcCount;
+}
+
+const Point &MappedGraph::getCoordinate(int vertex) const
+{
+    return coordinates[vertex];
+}
+
+uint32_t MappedGraph::getDegree(int vertex) const
+{
+    return offsets[vertex + 1] - offsets[vertex];
+}
+
+bool MappedGraph::isConnected() const
+{
+    return search::isConnected(*this);
+}
+
+std::vector<int> MappedGraph::djikstra(int start) const
+{
+    return search::djikstra(*this, start);
+}
+
+size_t MappedGraph::djikstra(int start, int *distances, const search::DijkstraLimits &limits) const
+{
+    return search::djikstra(*this, start, distances, limits);
+}
+
+int MappedGraph::heuristic(int current, int finish) const
+{
+    return search::heuristic(*this, heuristicMode, current, finish);
+}
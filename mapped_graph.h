@@ -0,0 +1,104 @@
+#pragma once
+
+#include "geometry.h"
+#include "graph_file.h"
+#include "search.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only graph backed by a memory-mapped graph file (see graph_file.h).
+//
+// Opening only maps the file and checks the header, nothing is parsed or
+// copied, so even a multi-GB graph opens instantly; pages are read in by the
+// OS as the searches touch them. The arrays are used in place, laid out like
+// CsrGraph, and the searches from search.h run on it directly.
+//
+// Beyond the header checks the contents are trusted, so only open files
+// written by graphfile::save.
+class MappedGraph
+{
+private:
+    const char *data = nullptr;
+    uint64_t size = 0;
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+
+    uint32_t vertexCount = 0;
+    uint64_t arcCount = 0;
+    const uint64_t *offsets = nullptr;
+    const uint32_t *neighbors = nullptr;
+    const int32_t *weights = nullptr;
+    const Point *coordinates = nullptr;
+    const char *vertexNames = nullptr;
+    static HeuristicModes heuristicMode;
+
+    void unmap();
+
+public:
+    // throws std::runtime_error when the file cannot be mapped or is not a
+    // graph file of a supported version
+    explicit MappedGraph(const std::string &path);
+    ~MappedGraph();
+
+    MappedGraph(const MappedGraph &) = delete;
+    MappedGraph &operator=(const MappedGraph &) = delete;
+
+    static void setHeuristic(HeuristicModes);
+
+    // size of the mapping in bytes
+    uint64_t getFileSize() const;
+
+    char getVertexName(int vertex) const;
+
+    uint32_t getVertexCount() const;
+
+    uint64_t getEdgeCount() const;
+
+    const Point &getCoordinate(int vertex) const;
+
+    uint32_t getDegree(int vertex) const;
+
+    // calls f(neighbor, weight) for every edge leaving "vertex"
+    template <typename F>
+    void forEachNeighbor(int vertex, F f) const;
+
+    bool isConnected() const;
+
+    std::vector<int> djikstra(int start) const;
+
+    size_t djikstra(int start, int *distances, const search::DijkstraLimits &limits = {}) const;
+
+    int heuristic(int current, int finish) const;
+
+    template <typename OpenSet = BinaryHeap>
+    std::vector<int> aStarSearch(int start, int finish) const;
+
+    // allocation-free variant, the path is left in workspace.path
+    template <typename OpenSet>
+    bool aStarSearch(int start, int finish, SearchWorkspace<OpenSet> &workspace) const;
+};
+
+template <typename OpenSet>
+std::vector<int> MappedGraph::aStarSearch(int start, int finish) const
+{
+    return search::aStarSearch<OpenSet>(*this, start, finish, heuristicMode);
+}
+
+template <typename OpenSet>
+bool MappedGraph::aStarSearch(int start, int finish, SearchWorkspace<OpenSet> &workspace) const
+{
+    return search::aStarSearch(*this, start, finish, heuristicMode, workspace);
+}
+
+template <typename F>
+void MappedGraph::forEachNeighbor(int vertex, F f) const
+{
+    const uint64_t end = offsets[vertex + 1];
+    for (uint64_t i = offsets[vertex]; i < end; i++)
+    {
+        f(neighbors[i], weights[i]);
+    }
+}
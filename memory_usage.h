@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+// Bytes a graph layout holds, split into what grows with the vertex count
+// (offsets, names, coordinates) and what grows with the edges (neighbor ids,
+// weights, adjacency bits). Indexes built on top, like the spatial index, are
+// counted separately in indexBytes, and only once they exist.
+struct MemoryUsage
+{
+    size_t vertexBytes = 0;
+    size_t edgeBytes = 0;
+    size_t indexBytes = 0;
+
+    size_t getTotalBytes() const
+    {
+        return vertexBytes + edgeBytes + indexBytes;
+    }
+
+    double getBytesPerVertex(size_t vertexCount) const
+    {
+        return vertexCount > 0 ? static_cast<double>(vertexBytes) / vertexCount : 0;
+    }
+
+    double getBytesPerEdge(size_t edgeCount) const
+    {
+        return edgeCount > 0 ? static_cast<double>(edgeBytes) / edgeCount : 0;
+    }
+};
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "search.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace search
+{
+    // Direction-optimizing breadth-first search on the workers of "pool".
+    //
+    // Each level is expanded in one of two directions. Top-down, the workers
+    // claim chunks of the frontier and claim its unvisited neighbors with
+    // compare-and-swap, which is cheap while the frontier is small. Bottom-up,
+    // every unvisited vertex looks for a neighbor in the frontier bitmap and
+    // claims only itself; once the frontier holds a large part of the graph this
+    // avoids the contended compare-and-swap on every edge, and the lookups stop
+    // at the first hit (the neighbor scan itself cannot stop early). The search
+    // goes bottom-up when the frontier outgrows the unvisited vertices divided
+    // by "growFactor" and back when it shrinks below the vertex count divided by
+    // "shrinkFactor" (the edge-count rule of Beamer et al. with uniform
+    // degrees). The graph must be undirected for the bottom-up levels.
+    //
+    // Writes the depth of every vertex into "depths", which must hold
+    // getVertexCount() ints, INF when it is unreachable, and returns the number
+    // of reached vertices. "bottomUpLevels", when given, receives how many levels
+    // went bottom-up.
+    template <typename G>
+    size_t parallelBreadthFirstSearch(const G &g, int start, int *depths, ThreadPool &pool,
+                                      unsigned *bottomUpLevels = nullptr)
+    {
+        const uint32_t vertexCount = g.getVertexCount();
+        const unsigned workerCount = pool.getThreadCount();
+        const size_t wordCount = (static_cast<size_t>(vertexCount) + 63) / 64;
+        const uint64_t growFactor = 14;
+        const uint64_t shrinkFactor = 24;
+        // work claimed at a time: frontier vertices top-down, bitmap words bottom-up
+        const size_t frontierChunk = 64;
+        const size_t wordChunk = 16;
+
+        struct Worker
+        {
+            std::vector<int> frontier;
+            std::vector<int> next;
+            std::vector<size_t> frontierOffsets;
+            size_t frontierSize = 0;
+            size_t reached = 0;
+        };
+        std::vector<Worker> workers(workerCount);
+
+        std::vector<std::atomic<int>> depth(vertexCount);
+        // frontier bitmaps of the even and the odd levels
+        std::vector<std::atomic<uint64_t>> bitmaps[2] = {std::vector<std::atomic<uint64_t>>(wordCount),
+                                                          std::vector<std::atomic<uint64_t>>(wordCount)};
+        std::atomic<size_t> claimed{0};
+        unsigned bottomUpCount = 0;
+        SpinBarrier barrier(workerCount);
+
+        pool.run([&](unsigned workerIndex)
+        {
+            Worker &self = workers[workerIndex];
+            const uint32_t begin = static_cast<uint64_t>(vertexCount) * workerIndex / workerCount;
+            const uint32_t end = static_cast<uint64_t>(vertexCount) * (workerIndex + 1) / workerCount;
+            const size_t wordBegin = wordCount * workerIndex / workerCount;
+            const size_t wordEnd = wordCount * (workerIndex + 1) / workerCount;
+
+            for (uint32_t v = begin; v < end; v++)
+            {
+                depth[v].store(INF, std::memory_order_relaxed);
+            }
+            for (size_t i = wordBegin; i < wordEnd; i++)
+            {
+                bitmaps[0][i].store(0, std::memory_order_relaxed);
+                bitmaps[1][i].store(0, std::memory_order_relaxed);
+            }
+            barrier.wait();
+
+            if (workerIndex == 0)
+            {
+                depth[start].store(0);
+                bitmaps[0][start >> 6].store(uint64_t(1) << (start & 63));
+                self.frontier.push_back(start);
+                self.frontierSize = 1;
+            }
+            barrier.wait();
+
+            // every worker takes the same decisions from the same shared counts
+            uint64_t unvisited = vertexCount;
+            bool bottomUp = false;
+
+            for (int level = 0;; level++)
+            {
+                const std::vector<std::atomic<uint64_t>> &current = bitmaps[level & 1];
+                std::vector<std::atomic<uint64_t>> &next = bitmaps[(level + 1) & 1];
+
+                self.frontierOffsets.assign(1, 0);
+                for (const Worker &worker : workers)
+                {
+                    self.frontierOffsets.push_back(self.frontierOffsets.back() + worker.frontierSize);
+                }
+                const size_t frontierSize = self.frontierOffsets.back();
+                if (frontierSize == 0)
+                    break;
+
+                unvisited -= frontierSize;
+                if (!bottomUp && frontierSize > unvisited / growFactor)
+                    bottomUp = true;
+                else if (bottomUp && frontierSize < vertexCount / shrinkFactor)
+                    bottomUp = false;
+                if (bottomUp && workerIndex == 0)
+                    bottomUpCount++;
+
+                auto discover = [&](int vertex)
+                {
+                    self.next.push_back(vertex);
+                    next[vertex >> 6].fetch_or(uint64_t(1) << (vertex & 63), std::memory_order_relaxed);
+                };
+
+                size_t first;
+                if (bottomUp)
+                {
+                    while ((first = claimed.fetch_add(wordChunk)) < wordCount)
+                    {
+                        const uint32_t last = std::min<uint64_t>((first + wordChunk) * 64, vertexCount);
+                        for (uint32_t v = first * 64; v < last; v++)
+                        {
+                            if (depth[v].load(std::memory_order_relaxed) != INF)
+                                continue;
+
+                            // forEachNeighbor cannot stop early, a hit only skips
+                            // the remaining bitmap lookups
+                            bool found = false;
+                            g.forEachNeighbor(v, [&](int neighbor, int)
+                            {
+                                if (!found)
+                                    found = current[neighbor >> 6].load(std::memory_order_relaxed) >> (neighbor & 63) & 1;
+                            });
+                            if (found)
+                            {
+                                depth[v].store(level + 1, std::memory_order_relaxed);
+                                discover(v);
+                            }
+                        }
+                    }
+                }
+                else
+                {
+                    while ((first = claimed.fetch_add(frontierChunk)) < frontierSize)
+                    {
+                        const size_t last = std::min(first + frontierChunk, frontierSize);
+                        unsigned part = 0;
+                        for (size_t i = first; i < last; i++)
+                        {
+                            while (self.frontierOffsets[part + 1] <= i)
+                            {
+                                part++;
+                            }
+                            const int vertex = workers[part].frontier[i - self.frontierOffsets[part]];
+
+                            g.forEachNeighbor(vertex, [&](int neighbor, int)
+                            {
+                                int unreached = INF;
+                                if (depth[neighbor].load(std::memory_order_relaxed) == INF &&
+                                    depth[neighbor].compare_exchange_strong(unreached, level + 1,
+                                                                            std::memory_order_relaxed))
+                                    discover(neighbor);
+                            });
+                        }
+                    }
+                }
+                barrier.wait();
+
+                // nobody reads the frontier lists or this level's bitmap any more;
+                // the bitmap is cleared for reuse two levels down
+                for (size_t i = wordBegin; i < wordEnd; i++)
+                {
+                    bitmaps[level & 1][i].store(0, std::memory_order_relaxed);
+                }
+                if (workerIndex == 0)
+                    claimed.store(0);
+                self.frontier.swap(self.next);
+                self.next.clear();
+                self.frontierSize = self.frontier.size();
+                barrier.wait();
+            }
+
+            for (uint32_t v = begin; v < end; v++)
+            {
+                depths[v] = depth[v].load(std::memory_order_relaxed);
+                if (depths[v] != INF)
+                    self.reached++;
+            }
+        });
+
+        if (bottomUpLevels)
+            *bottomUpLevels = bottomUpCount;
+
+        size_t reached = 0;
+        for (const Worker &worker : workers)
+        {
+            reached += worker.reached;
+        }
+        return reached;
+    }
+}
@@ -0,0 +1,87 @@
+#include "reordering.h"
+#include <limits>
+#include <utility>
+
+const char *getVertexOrderName(VertexOrder order)
+{
+    switch (order)
+    {
+    case VertexOrder::identity:
+        return "identity";
+    case VertexOrder::hilbert:
+        return "hilbert";
+    case VertexOrder::bfs:
+        return "bfs";
+    case VertexOrder::rcm:
+        return "rcm";
+    default:
+        return "unknown";
+    }
+}
+
+void ReorderedGraph::toExternalPath(std::vector<int> &path) const
+{
+    for (int &vertex : path)
+    {
+        vertex = toExternal[vertex];
+    }
+}
+
+uint64_t reorder::getHilbertIndex(uint32_t x, uint32_t y, unsigned order)
+{
+    uint64_t index = 0;
+    for (uint32_t side = uint32_t(1) << (order - 1); side > 0; side >>= 1)
+    {
+        const uint32_t rx = (x & side) > 0;
+        const uint32_t ry = (y & side) > 0;
+        index += static_cast<uint64_t>(side) * side * ((3 * rx) ^ ry);
+
+        // rotate the quadrant so the curve stays continuous
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = side - 1 - (x & (side - 1));
+                y = side - 1 - (y & (side - 1));
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+std::vector<uint32_t> reorder::hilbertOrder(const std::vector<Point> &coordinates)
+{
+    const unsigned gridOrder = 16;
+    const uint32_t vertexCount = coordinates.size();
+
+    int minX = std::numeric_limits<int>::max(), minY = std::numeric_limits<int>::max();
+    int maxX = std::numeric_limits<int>::min(), maxY = std::numeric_limits<int>::min();
+    for (const Point &p : coordinates)
+    {
+        minX = std::min(minX, p.x);
+        minY = std::min(minY, p.y);
+        maxX = std::max(maxX, p.x);
+        maxY = std::max(maxY, p.y);
+    }
+
+    // the same scale on both axes keeps the curve's cells square
+    const int64_t extent = std::max<int64_t>(1, std::max<int64_t>(int64_t(maxX) - minX, int64_t(maxY) - minY));
+    const int64_t cells = int64_t(1) << gridOrder;
+
+    std::vector<std::pair<uint64_t, uint32_t>> keyed(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        const uint32_t x = (coordinates[v].x - int64_t(minX)) * (cells - 1) / extent;
+        const uint32_t y = (coordinates[v].y - int64_t(minY)) * (cells - 1) / extent;
+        keyed[v] = {getHilbertIndex(x, y, gridOrder), v};
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    std::vector<uint32_t> order(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        order[i] = keyed[i].second;
+    }
+    return order;
+}
@@ -0,0 +1,502 @@
+#pragma once
+
+#include "geometry.h"
+#include "heap.h"
+#include "heuristics.h"
+#include "search_stats.h"
+#include "search_workspace.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Search algorithms shared by every graph type.
+//
+// A graph type only has to provide:
+//   uint32_t getVertexCount() const;
+//   char getVertexName(int vertex) const;
+//   const Point &getCoordinate(int vertex) const;
+//   template <typename F> void forEachNeighbor(int vertex, F f) const;  // f(int neighbor, int weight)
+//
+// so that neighbor expansion costs whatever the graph's storage makes it cost:
+// a full row for the dense Graph<N>, O(degree) for CsrGraph.
+namespace search
+{
+    const int INF = std::numeric_limits<int>::max();
+
+    // single evaluation with a runtime mode, searches use the policies directly
+    template <typename G>
+    int heuristic(const G &g, HeuristicModes mode, int current, int finish)
+    {
+        return dispatchHeuristic(mode, [&](auto metric)
+        {
+            return metric(g.getCoordinate(current), g.getCoordinate(finish));
+        });
+    }
+
+    inline std::vector<int> reconstructPath(const int *cameFrom, int end)
+    {
+        std::vector<int> path;
+
+        path.push_back(end);
+        // construct path
+        int currentVertex = cameFrom[end];
+
+        while (currentVertex != -1)
+        {
+            path.push_back(currentVertex);
+            currentVertex = cameFrom[currentVertex];
+        }
+
+        std::reverse(path.begin(), path.end());
+
+        return path;
+    }
+
+    // Iterative depth-first traversal from "start" in the same order as the
+    // recursive one: onDiscover(vertex) when a vertex is entered, before its
+    // neighbors, and onFinish(vertex) when the traversal backtracks from it. An
+    // explicit stack replaces the call stack, so deep graphs cannot overflow it.
+    // Returns the number of discovered vertices; "stats" in the workspace counts
+    // them as pops, stack entries as pushes and scanned edges as relaxed.
+    template <typename G, typename Discover, typename Finish>
+    size_t depthFirstSearch(const G &g, int start, TraversalWorkspace &workspace, Discover onDiscover, Finish onFinish)
+    {
+        VisitedSet &visited = workspace.visited;
+        std::vector<int> &stack = workspace.stack;
+        visited.reset(g.getVertexCount());
+        stack.clear();
+        ASTAR_STATS(workspace.stats.clear());
+
+        size_t discovered = 0;
+        stack.push_back(start);
+        ASTAR_STATS(workspace.stats.pushes++);
+
+        while (!stack.empty())
+        {
+            int entry = stack.back();
+            stack.pop_back();
+
+            if (entry < 0)
+            {
+                onFinish(~entry);
+                continue;
+            }
+            // queued by several neighbors, entered by the first
+            if (!visited.insert(entry))
+                continue;
+
+            onDiscover(entry);
+            discovered++;
+            ASTAR_STATS(workspace.stats.pops++);
+
+            // the neighbors go on top of the leave entry, reversed so the first
+            // one is entered first, as the recursion would
+            stack.push_back(~entry);
+            const size_t first = stack.size();
+            g.forEachNeighbor(entry, [&](int neighbor, int)
+            {
+                ASTAR_STATS(workspace.stats.relaxed++);
+                if (!visited.contains(neighbor))
+                {
+                    stack.push_back(neighbor);
+                    ASTAR_STATS(workspace.stats.pushes++);
+                }
+            });
+            std::reverse(stack.begin() + first, stack.end());
+            ASTAR_STATS(workspace.stats.peakOpenSetSize = std::max(workspace.stats.peakOpenSetSize, stack.size()));
+        }
+        return discovered;
+    }
+
+    // Breadth-first traversal from "start", calling onVisit(vertex, depth) in
+    // visiting order, depth being the number of edges from "start". Returns the
+    // number of visited vertices; "stats" counts queue operations and scanned
+    // edges.
+    template <typename G, typename Visit>
+    size_t breathFirstSearch(const G &g, int start, TraversalWorkspace &workspace, Visit onVisit)
+    {
+        VisitedSet &visited = workspace.visited;
+        std::vector<int> &queue = workspace.queue;
+        visited.reset(g.getVertexCount());
+        queue.resize(g.getVertexCount());
+        ASTAR_STATS(workspace.stats.clear());
+
+        size_t head = 0, tail = 0;
+        queue[tail++] = start;
+        visited.insert(start);
+        ASTAR_STATS(workspace.stats.pushes++);
+
+        // queue[levelEnd] is the first vertex one level deeper
+        size_t levelEnd = tail;
+        int depth = 0;
+
+        while (head < tail)
+        {
+            if (head == levelEnd)
+            {
+                levelEnd = tail;
+                depth++;
+            }
+
+            int currentVertex = queue[head++];
+            ASTAR_STATS(workspace.stats.pops++);
+            onVisit(currentVertex, depth);
+
+            g.forEachNeighbor(currentVertex, [&](int neighbor, int)
+            {
+                ASTAR_STATS(workspace.stats.relaxed++);
+                if (visited.insert(neighbor))
+                {
+                    queue[tail++] = neighbor;
+                    ASTAR_STATS(workspace.stats.pushes++);
+                }
+            });
+            ASTAR_STATS(workspace.stats.peakOpenSetSize = std::max(workspace.stats.peakOpenSetSize, tail - head));
+        }
+        return tail;
+    }
+
+    // discovery order of a depth-first traversal, for callers without a workspace
+    template <typename G>
+    std::vector<int> depthFirstOrder(const G &g, int start)
+    {
+        TraversalWorkspace workspace;
+        std::vector<int> order;
+        depthFirstSearch(g, start, workspace, [&](int vertex)
+        {
+            order.push_back(vertex);
+        },
+                         [](int)
+        {
+        });
+        return order;
+    }
+
+    template <typename G>
+    std::vector<int> breadthFirstOrder(const G &g, int start)
+    {
+        TraversalWorkspace workspace;
+        std::vector<int> order;
+        breathFirstSearch(g, start, workspace, [&](int vertex, int)
+        {
+            order.push_back(vertex);
+        });
+        return order;
+    }
+
+    // early exit conditions for djikstra
+    struct DijkstraLimits
+    {
+        // stop once all of these vertices are settled, run to completion when empty
+        const int *targets = nullptr;
+        size_t targetCount = 0;
+        // stop before settling a vertex farther than this
+        int maxDistance = INF;
+    };
+
+    // Writes into "distances", which must hold getVertexCount() ints, and returns
+    // the number of settled vertices. Settled vertices hold their exact distance;
+    // after an early exit the others hold INF or a tentative upper bound.
+    // "stats", when given, receives the operation counts of the run.
+    template <typename OpenSet = BinaryHeap, typename G>
+    size_t djikstra(const G &g, int start, int *distances, const DijkstraLimits &limits = {},
+                    SearchStats *stats = nullptr)
+    {
+        const size_t vertexCount = g.getVertexCount();
+
+        std::fill(distances, distances + vertexCount, INF);
+
+        OpenSet queue;
+        queue.reserve(vertexCount);
+
+        size_t remainingTargets = limits.targetCount;
+        size_t settled = 0;
+
+        SearchStats counts;
+
+        distances[start] = 0;
+        queue.push(start, 0);
+        ASTAR_STATS(counts.pushes++);
+
+        while (!queue.empty())
+        {
+            if (queue.topKey() > limits.maxDistance)
+                break;
+
+            // with non-negative weights a popped vertex never improves again,
+            // so no separate visited set is needed
+            int closestVertex = queue.pop();
+            settled++;
+            ASTAR_STATS(counts.pops++);
+
+            for (size_t i = 0; i < limits.targetCount; i++)
+            {
+                if (limits.targets[i] == closestVertex)
+                    remainingTargets--;
+            }
+            if (limits.targetCount != 0 && remainingTargets == 0)
+                break;
+
+            // update distances to all adjancent vertices
+            int distance = distances[closestVertex];
+            g.forEachNeighbor(closestVertex, [&](int neighbor, int weight)
+            {
+                ASTAR_STATS(counts.relaxed++);
+                int newDistance = distance + weight;
+                if (newDistance < distances[neighbor])
+                {
+                    ASTAR_STATS(queue.contains(neighbor) ? counts.decreaseKeys++ : counts.pushes++);
+                    distances[neighbor] = newDistance;
+                    queue.push(neighbor, newDistance);
+                    ASTAR_STATS(counts.peakOpenSetSize = std::max(counts.peakOpenSetSize, queue.size()));
+                }
+            });
+        }
+
+        if (stats)
+            *stats = counts;
+        return settled;
+    }
+
+    // full single-source run, distances of unreachable vertices are left at INF
+    template <typename G>
+    std::vector<int> djikstra(const G &g, int start)
+    {
+        std::vector<int> distances(g.getVertexCount());
+        djikstra(g, start, distances.data());
+        return distances;
+    }
+
+    // every vertex reachable from vertex 0; only reachability matters, so a
+    // breadth-first sweep replaces the full djikstra run
+    template <typename G>
+    bool isConnected(const G &g)
+    {
+        if (g.getVertexCount() == 0)
+            return true;
+
+        TraversalWorkspace workspace;
+        return breathFirstSearch(g, 0, workspace, [](int, int)
+        {
+        }) == g.getVertexCount();
+    }
+
+    // Whether every arc u -> v has a twin v -> u of the same weight, which the
+    // searches for undirected graphs (bidirectional A*, ALT) rely on. Copies
+    // the adjacency into sorted (neighbor, weight) lists, O(E log degree).
+    template <typename G>
+    bool isSymmetric(const G &g)
+    {
+        const uint32_t vertexCount = g.getVertexCount();
+
+        std::vector<size_t> offsets(vertexCount + 1, 0);
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            offsets[v + 1] = offsets[v];
+            g.forEachNeighbor(v, [&](int, int)
+            {
+                offsets[v + 1]++;
+            });
+        }
+
+        std::vector<std::pair<int, int>> arcs(offsets[vertexCount]);
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            size_t next = offsets[v];
+            g.forEachNeighbor(v, [&](int neighbor, int weight)
+            {
+                arcs[next++] = {neighbor, weight};
+            });
+            std::sort(arcs.begin() + offsets[v], arcs.begin() + offsets[v + 1]);
+        }
+
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            for (size_t i = offsets[v]; i < offsets[v + 1]; i++)
+            {
+                const uint32_t neighbor = arcs[i].first;
+                if (!std::binary_search(arcs.begin() + offsets[neighbor], arcs.begin() + offsets[neighbor + 1],
+                                        std::make_pair(static_cast<int>(v), arcs[i].second)))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // Runs A* using the scratch state in "workspace" and leaves the path in
+    // workspace.path. Returns false when "finish" is unreachable.
+    // "OpenSet" is one of the priority queue policies from heap.h, keyed on fScore,
+    // and "heuristic" is any h(vertex) callable bound to "finish", such as a
+    // PointHeuristic, so it is inlined into the relaxation loop.
+    template <typename OpenSet, typename G, typename H>
+    bool aStarSearch(const G &g, int start, int finish, const H &heuristic, SearchWorkspace<OpenSet> &workspace)
+    {
+        workspace.reset(g.getVertexCount());
+        OpenSet &openSet = workspace.openSet;
+
+        workspace.setScore(start, 0, -1);
+        workspace.push(start, heuristic(start));
+        ASTAR_STATS(workspace.stats.heuristicEvaluations++);
+
+        while (!openSet.empty())
+        {
+            // get vertex with the least fScore from openSet
+            int currentVertex = workspace.settle();
+
+            // if it is the goal vertex
+            if (currentVertex == finish)
+            {
+                workspace.reconstructPath(currentVertex);
+                return true;
+            }
+
+            int currentGScore = workspace.getGScore(currentVertex);
+            g.forEachNeighbor(currentVertex, [&](int neighbor, int weight)
+            {
+                ASTAR_STATS(workspace.stats.relaxed++);
+                int newGScore = currentGScore + weight;
+
+                // if better path is found to vertex "neighbor"
+                if (newGScore < workspace.getGScore(neighbor))
+                {
+                    workspace.setScore(neighbor, newGScore, currentVertex);
+                    workspace.push(neighbor, newGScore + heuristic(neighbor));
+                    ASTAR_STATS(workspace.stats.heuristicEvaluations++);
+                }
+            });
+        }
+
+        return false;
+    }
+
+    // selects the heuristic policy for "mode" once per query
+    template <typename OpenSet, typename G>
+    bool aStarSearch(const G &g, int start, int finish, HeuristicModes mode, SearchWorkspace<OpenSet> &workspace)
+    {
+        return dispatchHeuristic(mode, [&](auto metric)
+        {
+            return aStarSearch(g, start, finish, makePointHeuristic(g, metric, finish), workspace);
+        });
+    }
+
+    // same as above with the calling thread's workspace, throws when there is no path
+    template <typename OpenSet = BinaryHeap, typename G>
+    std::vector<int> aStarSearch(const G &g, int start, int finish, HeuristicModes mode)
+    {
+        SearchWorkspace<OpenSet> &workspace = threadWorkspace<OpenSet>();
+
+        if (!aStarSearch(g, start, finish, mode, workspace))
+            throw std::logic_error("Not path found");
+
+        return workspace.path;
+    }
+
+    // Bidirectional A* with the average potential p(v) = (h_finish(v) - h_start(v)) / 2.
+    //
+    // The forward search orders vertices by d_start(v) + p(v) and the backward one
+    // by d_finish(v) - p(v). Both use the same reduced edge costs, so the search
+    // can stop as soon as the two smallest keys add up to the best path seen.
+    // Keys are doubled to keep them integral. "toFinish" and "toStart" are h(vertex)
+    // callables bound to either end, the graph must be undirected.
+    template <typename OpenSet, typename G, typename H>
+    bool bidirectionalAStarSearch(const G &g, int start, int finish, const H &toFinish, const H &toStart,
+                                  BidirectionalWorkspace<OpenSet> &workspace)
+    {
+        SearchWorkspace<OpenSet> &forward = workspace.forward;
+        SearchWorkspace<OpenSet> &backward = workspace.backward;
+
+        forward.reset(g.getVertexCount());
+        backward.reset(g.getVertexCount());
+        workspace.path.clear();
+
+        auto potential = [&](int vertex)
+        {
+            return toFinish(vertex) - toStart(vertex);
+        };
+
+        forward.setScore(start, 0, -1);
+        forward.push(start, potential(start));
+        backward.setScore(finish, 0, -1);
+        backward.push(finish, -potential(finish));
+        ASTAR_STATS(forward.stats.heuristicEvaluations += 2);
+        ASTAR_STATS(backward.stats.heuristicEvaluations += 2);
+
+        int best = INF;
+        int meeting = -1;
+
+        // settles one vertex of "self", "sign" turns the potential around for the backward side
+        auto expand = [&](SearchWorkspace<OpenSet> &self, const SearchWorkspace<OpenSet> &other, int sign)
+        {
+            int currentVertex = self.settle();
+
+            int currentScore = self.getGScore(currentVertex);
+            if (other.isReached(currentVertex) && currentScore + other.getGScore(currentVertex) < best)
+            {
+                best = currentScore + other.getGScore(currentVertex);
+                meeting = currentVertex;
+            }
+
+            g.forEachNeighbor(currentVertex, [&](int neighbor, int weight)
+            {
+                ASTAR_STATS(self.stats.relaxed++);
+                int newScore = currentScore + weight;
+                if (newScore < self.getGScore(neighbor))
+                {
+                    self.setScore(neighbor, newScore, currentVertex);
+                    self.push(neighbor, 2 * newScore + sign * potential(neighbor));
+                    // the potential evaluates both heuristics
+                    ASTAR_STATS(self.stats.heuristicEvaluations += 2);
+
+                    // the two searches touch, a path through "neighbor" exists
+                    if (other.isReached(neighbor) && newScore + other.getGScore(neighbor) < best)
+                    {
+                        best = newScore + other.getGScore(neighbor);
+                        meeting = neighbor;
+                    }
+                }
+            });
+        };
+
+        // once either side runs dry every path has been seen
+        while (!forward.openSet.empty() && !backward.openSet.empty())
+        {
+            int64_t lowest = static_cast<int64_t>(forward.openSet.topKey()) + backward.openSet.topKey();
+            if (best != INF && lowest >= 2 * static_cast<int64_t>(best))
+                break;
+
+            // grow the smaller frontier
+            if (forward.openSet.size() <= backward.openSet.size())
+                expand(forward, backward, 1);
+            else
+                expand(backward, forward, -1);
+        }
+
+        if (meeting == -1)
+            return false;
+
+        // start -> meeting from the forward tree, meeting -> finish from the backward one
+        forward.reconstructPath(meeting);
+        workspace.path = forward.path;
+        for (int vertex = backward.getCameFrom(meeting); vertex != -1; vertex = backward.getCameFrom(vertex))
+        {
+            workspace.path.push_back(vertex);
+        }
+
+        return true;
+    }
+
+    // selects the heuristic policy for "mode" once per query
+    template <typename OpenSet, typename G>
+    bool bidirectionalAStarSearch(const G &g, int start, int finish, HeuristicModes mode,
+                                  BidirectionalWorkspace<OpenSet> &workspace)
+    {
+        return dispatchHeuristic(mode, [&](auto metric)
+        {
+            return bidirectionalAStarSearch(g, start, finish, makePointHeuristic(g, metric, finish),
+                                            makePointHeuristic(g, metric, start), workspace);
+        });
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Operation counters of the searches.
+//
+// The counting statements are wrapped in ASTAR_STATS, which expands to nothing
+// unless the build defines ASTAR_ENABLE_STATS (the CMake option of the same
+// name), so a build without it runs exactly the uninstrumented loops. Settled
+// vertices are counted in every build, see SearchWorkspace::settled.
+#ifdef ASTAR_ENABLE_STATS
+#define ASTAR_STATS(statement) statement
+#else
+#define ASTAR_STATS(statement)
+#endif
+
+struct SearchStats
+{
+    // edges looked at from settled vertices
+    uint64_t relaxed = 0;
+    // vertices put on the open set for the first time
+    uint64_t pushes = 0;
+    uint64_t pops = 0;
+    // keys lowered for vertices already on the open set
+    uint64_t decreaseKeys = 0;
+    uint64_t heuristicEvaluations = 0;
+    size_t peakOpenSetSize = 0;
+
+    void clear()
+    {
+        *this = SearchStats();
+    }
+
+    SearchStats &operator+=(const SearchStats &other)
+    {
+        relaxed += other.relaxed;
+        pushes += other.pushes;
+        pops += other.pops;
+        decreaseKeys += other.decreaseKeys;
+        heuristicEvaluations += other.heuristicEvaluations;
+        peakOpenSetSize += other.peakOpenSetSize;
+        return *this;
+    }
+};
+
+inline std::ostream &operator<<(std::ostream &out, const SearchStats &stats)
+{
+    return out << "relaxed " << stats.relaxed << ", pushes " << stats.pushes << ", pops " << stats.pops
+               << ", decrease-keys " << stats.decreaseKeys << ", heuristic evaluations " << stats.heuristicEvaluations
+               << ", peak open set " << stats.peakOpenSetSize;
+}
+
+namespace search
+{
+    // Writes an expansion trace, as recorded through SearchWorkspace::trace, as
+    // CSV: one "step,vertex,name,x,y" line per settled vertex in settling order.
+    template <typename G>
+    void writeTrace(std::ostream &out, const G &g, const std::vector<int> &trace)
+    {
+        out << "step,vertex,name,x,y\n";
+        for (size_t step = 0; step < trace.size(); step++)
+        {
+            const int vertex = trace[step];
+            const auto coordinate = g.getCoordinate(vertex);
+            out << step << ',' << vertex << ',' << g.getVertexName(vertex) << ',' << coordinate.x << ','
+                << coordinate.y << '\n';
+        }
+    }
+}
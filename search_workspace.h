@@ -0,0 +1,184 @@
+#pragma once
+
+#include "heap.h"
+#include "search_stats.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Scratch state of a point-to-point search, meant to be reused across queries.
+//
+// Scores are generation-stamped: an entry only counts when its stamp matches the
+// current generation, so starting a new query is O(1) instead of refilling
+// O(V) arrays. The stamp, the score and the predecessor of a vertex are packed
+// in one 16-byte entry, so looking a vertex up touches a single cache line
+// instead of one per array. The open set and the output path keep their
+// capacity between queries, so a warmed-up workspace does not allocate at all.
+//
+// A workspace is not thread-safe; use one per thread (see threadWorkspace).
+template <typename OpenSet = BinaryHeap>
+class SearchWorkspace
+{
+private:
+    struct alignas(16) Entry
+    {
+        uint32_t stamp;
+        int gScore;
+        int cameFrom;
+    };
+
+    std::vector<Entry> entries;
+    uint32_t generation = 0;
+
+public:
+    OpenSet openSet;
+    // vertices of the last path found, start first
+    std::vector<int> path;
+    // vertices taken off the open set by the last query
+    size_t settled = 0;
+    // operation counts of the last query, see search_stats.h
+    SearchStats stats;
+    // when set, the last query's settled vertices in settling order
+    // (only recorded with ASTAR_ENABLE_STATS)
+    std::vector<int> *trace = nullptr;
+
+    // starts a new query on a graph with "vertexCount" vertices
+    void reset(size_t vertexCount)
+    {
+        if (entries.size() < vertexCount)
+            entries.resize(vertexCount, Entry{0, 0, 0});
+        openSet.reserve(vertexCount);
+        openSet.clear();
+        path.clear();
+        settled = 0;
+        ASTAR_STATS(stats.clear());
+        ASTAR_STATS(if (trace) trace->clear());
+
+        generation++;
+        if (generation == 0)
+        {
+            // stamps wrapped around, forget every old generation
+            for (Entry &entry : entries)
+            {
+                entry.stamp = 0;
+            }
+            generation = 1;
+        }
+    }
+
+    bool isReached(int vertex) const
+    {
+        return entries[vertex].stamp == generation;
+    }
+
+    int getGScore(int vertex) const
+    {
+        const Entry &entry = entries[vertex];
+        return entry.stamp == generation ? entry.gScore : std::numeric_limits<int>::max();
+    }
+
+    int getCameFrom(int vertex) const
+    {
+        const Entry &entry = entries[vertex];
+        return entry.stamp == generation ? entry.cameFrom : -1;
+    }
+
+    void setScore(int vertex, int score, int from)
+    {
+        entries[vertex] = Entry{generation, score, from};
+    }
+
+    // queues "vertex" or lowers its key, counting which of the two it was
+    template <typename Key>
+    void push(int vertex, Key key)
+    {
+        ASTAR_STATS(openSet.contains(vertex) ? stats.decreaseKeys++ : stats.pushes++);
+        openSet.push(vertex, key);
+        ASTAR_STATS(stats.peakOpenSetSize = std::max(stats.peakOpenSetSize, openSet.size()));
+    }
+
+    // takes the vertex with the least key off the open set and counts it as settled
+    int settle()
+    {
+        int vertex = openSet.pop();
+        settled++;
+        ASTAR_STATS(stats.pops++);
+        ASTAR_STATS(if (trace) trace->push_back(vertex));
+        return vertex;
+    }
+
+    // fills "path" by following cameFrom back from "end"
+    void reconstructPath(int end)
+    {
+        path.clear();
+        for (int vertex = end; vertex != -1; vertex = getCameFrom(vertex))
+        {
+            path.push_back(vertex);
+        }
+        std::reverse(path.begin(), path.end());
+    }
+};
+
+// Scratch state of the bidirectional searches: one workspace per direction,
+// each counting its own settled vertices, plus the joined path.
+template <typename OpenSet = BinaryHeap>
+struct BidirectionalWorkspace
+{
+    SearchWorkspace<OpenSet> forward;
+    SearchWorkspace<OpenSet> backward;
+    // vertices of the last path found, start first
+    std::vector<int> path;
+};
+
+// One bit per vertex. reset() reuses the words, so a traversal on a graph no
+// larger than the last one does not allocate, and clearing costs V / 64 stores.
+class VisitedSet
+{
+private:
+    std::vector<uint64_t> words;
+
+public:
+    void reset(size_t vertexCount)
+    {
+        words.assign((vertexCount + 63) / 64, 0);
+    }
+
+    bool contains(uint32_t vertex) const
+    {
+        return words[vertex >> 6] >> (vertex & 63) & 1;
+    }
+
+    // marks "vertex", returns false when it already was
+    bool insert(uint32_t vertex)
+    {
+        uint64_t &word = words[vertex >> 6];
+        const uint64_t bit = uint64_t(1) << (vertex & 63);
+        if (word & bit)
+            return false;
+        word |= bit;
+        return true;
+    }
+};
+
+// Scratch state of the depth- and breadth-first traversals, reused across
+// calls like SearchWorkspace.
+struct TraversalWorkspace
+{
+    VisitedSet visited;
+    // depth-first: vertices to enter, and ~vertex entries to leave one
+    std::vector<int> stack;
+    // breadth-first: every vertex is queued at most once, so a flat buffer
+    // with a head index serves as the queue
+    std::vector<int> queue;
+    // operation counts of the last traversal, see search_stats.h
+    SearchStats stats;
+};
+
+// workspace owned by the calling thread
+template <typename OpenSet = BinaryHeap>
+SearchWorkspace<OpenSet> &threadWorkspace()
+{
+    static thread_local SearchWorkspace<OpenSet> workspace;
+    return workspace;
+}
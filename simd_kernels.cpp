@@ -0,0 +1,272 @@
+#include "simd_kernels.h"
+#include <algorithm>
+#include <climits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ASTAR_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    size_t relaxRowScalar(const int *weights, uint32_t begin, uint32_t count, int base, int from, int *scores,
+                          int *cameFrom, uint32_t *improved)
+    {
+        size_t improvedCount = 0;
+        for (uint32_t i = begin; i < count; i++)
+        {
+            int weight = weights[i];
+            if (weight != 0 && base + weight < scores[i])
+            {
+                scores[i] = base + weight;
+                cameFrom[i] = from;
+                improved[improvedCount++] = i;
+            }
+        }
+        return improvedCount;
+    }
+
+    int argminScalar(const int *values, uint32_t count)
+    {
+        int best = -1;
+        int bestValue = INT_MAX;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (values[i] < bestValue)
+            {
+                bestValue = values[i];
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    size_t relaxRowPlain(const int *weights, uint32_t count, int base, int from, int *scores, int *cameFrom,
+                         uint32_t *improved)
+    {
+        return relaxRowScalar(weights, 0, count, base, from, scores, cameFrom, improved);
+    }
+
+#ifdef ASTAR_X86_KERNELS
+
+    // Both versions compare 4 or 8 columns at once. The stores and the improved
+    // list are only touched for blocks where some column improved, which is
+    // rare once the search has settled the nearby vertices.
+
+    __attribute__((target("sse4.1"))) size_t relaxRowSse41(const int *weights, uint32_t count, int base, int from,
+                                                          int *scores, int *cameFrom, uint32_t *improved)
+    {
+        const __m128i baseVector = _mm_set1_epi32(base);
+        const __m128i fromVector = _mm_set1_epi32(from);
+        const __m128i zero = _mm_setzero_si128();
+
+        size_t improvedCount = 0;
+        uint32_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i weight = _mm_loadu_si128(reinterpret_cast<const __m128i *>(weights + i));
+            __m128i score = _mm_loadu_si128(reinterpret_cast<const __m128i *>(scores + i));
+            __m128i candidate = _mm_add_epi32(baseVector, weight);
+            __m128i mask = _mm_andnot_si128(_mm_cmpeq_epi32(weight, zero), _mm_cmpgt_epi32(score, candidate));
+
+            if (_mm_testz_si128(mask, mask))
+                continue;
+
+            __m128i parent = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cameFrom + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(scores + i), _mm_blendv_epi8(score, candidate, mask));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(cameFrom + i), _mm_blendv_epi8(parent, fromVector, mask));
+
+            for (unsigned bits = _mm_movemask_ps(_mm_castsi128_ps(mask)); bits != 0; bits &= bits - 1)
+            {
+                improved[improvedCount++] = i + __builtin_ctz(bits);
+            }
+        }
+
+        return improvedCount + relaxRowScalar(weights, i, count, base, from, scores, cameFrom, improved + improvedCount);
+    }
+
+    __attribute__((target("sse4.1"))) int argminSse41(const int *values, uint32_t count)
+    {
+        // first the smallest value, then the first column holding it
+        __m128i smallest = _mm_set1_epi32(INT_MAX);
+        uint32_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            smallest = _mm_min_epi32(smallest, _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i)));
+        }
+        smallest = _mm_min_epi32(smallest, _mm_shuffle_epi32(smallest, _MM_SHUFFLE(1, 0, 3, 2)));
+        smallest = _mm_min_epi32(smallest, _mm_shuffle_epi32(smallest, _MM_SHUFFLE(2, 3, 0, 1)));
+
+        int bestValue = _mm_cvtsi128_si32(smallest);
+        for (uint32_t j = i; j < count; j++)
+        {
+            bestValue = std::min(bestValue, values[j]);
+        }
+        if (bestValue == INT_MAX)
+            return -1;
+
+        const __m128i target = _mm_set1_epi32(bestValue);
+        for (uint32_t j = 0; j + 4 <= count; j += 4)
+        {
+            __m128i equal = _mm_cmpeq_epi32(target, _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + j)));
+            int bits = _mm_movemask_ps(_mm_castsi128_ps(equal));
+            if (bits != 0)
+                return j + __builtin_ctz(bits);
+        }
+        for (uint32_t j = i; j < count; j++)
+        {
+            if (values[j] == bestValue)
+                return j;
+        }
+        return -1;
+    }
+
+    __attribute__((target("avx2"))) size_t relaxRowAvx2(const int *weights, uint32_t count, int base, int from,
+                                                        int *scores, int *cameFrom, uint32_t *improved)
+    {
+        const __m256i baseVector = _mm256_set1_epi32(base);
+        const __m256i fromVector = _mm256_set1_epi32(from);
+        const __m256i zero = _mm256_setzero_si256();
+
+        size_t improvedCount = 0;
+        uint32_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i weight = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights + i));
+            __m256i score = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(scores + i));
+            __m256i candidate = _mm256_add_epi32(baseVector, weight);
+            __m256i mask = _mm256_andnot_si256(_mm256_cmpeq_epi32(weight, zero), _mm256_cmpgt_epi32(score, candidate));
+
+            if (_mm256_testz_si256(mask, mask))
+                continue;
+
+            __m256i parent = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cameFrom + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(scores + i), _mm256_blendv_epi8(score, candidate, mask));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(cameFrom + i), _mm256_blendv_epi8(parent, fromVector, mask));
+
+            for (unsigned bits = _mm256_movemask_ps(_mm256_castsi256_ps(mask)); bits != 0; bits &= bits - 1)
+            {
+                improved[improvedCount++] = i + __builtin_ctz(bits);
+            }
+        }
+
+        return improvedCount + relaxRowScalar(weights, i, count, base, from, scores, cameFrom, improved + improvedCount);
+    }
+
+    __attribute__((target("avx2"))) int argminAvx2(const int *values, uint32_t count)
+    {
+        __m256i smallest = _mm256_set1_epi32(INT_MAX);
+        uint32_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            smallest = _mm256_min_epi32(smallest, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i)));
+        }
+        __m128i half = _mm_min_epi32(_mm256_castsi256_si128(smallest), _mm256_extracti128_si256(smallest, 1));
+        half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+        half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+
+        int bestValue = _mm_cvtsi128_si32(half);
+        for (uint32_t j = i; j < count; j++)
+        {
+            bestValue = std::min(bestValue, values[j]);
+        }
+        if (bestValue == INT_MAX)
+            return -1;
+
+        const __m256i target = _mm256_set1_epi32(bestValue);
+        for (uint32_t j = 0; j + 8 <= count; j += 8)
+        {
+            __m256i equal = _mm256_cmpeq_epi32(target, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + j)));
+            int bits = _mm256_movemask_ps(_mm256_castsi256_ps(equal));
+            if (bits != 0)
+                return j + __builtin_ctz(bits);
+        }
+        for (uint32_t j = i; j < count; j++)
+        {
+            if (values[j] == bestValue)
+                return j;
+        }
+        return -1;
+    }
+
+#endif
+
+    struct Kernels
+    {
+        SimdLevel level;
+        size_t (*relaxRow)(const int *, uint32_t, int, int, int *, int *, uint32_t *);
+        int (*argmin)(const int *, uint32_t);
+    };
+
+    Kernels selectKernels(SimdLevel level)
+    {
+#ifdef ASTAR_X86_KERNELS
+        if (level == SimdLevel::avx2)
+            return {SimdLevel::avx2, relaxRowAvx2, argminAvx2};
+        if (level == SimdLevel::sse41)
+            return {SimdLevel::sse41, relaxRowSse41, argminSse41};
+#endif
+        return {SimdLevel::scalar, relaxRowPlain, argminScalar};
+    }
+
+    SimdLevel detectLevel()
+    {
+#ifdef ASTAR_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return SimdLevel::avx2;
+        if (__builtin_cpu_supports("sse4.1"))
+            return SimdLevel::sse41;
+#endif
+        return SimdLevel::scalar;
+    }
+
+    // function-local so that searches run from other static initializers work too
+    Kernels &activeKernels()
+    {
+        static Kernels kernels = selectKernels(detectLevel());
+        return kernels;
+    }
+}
+
+namespace simd
+{
+    SimdLevel getSupportedLevel()
+    {
+        return detectLevel();
+    }
+
+    SimdLevel getLevel()
+    {
+        return activeKernels().level;
+    }
+
+    void setLevel(SimdLevel level)
+    {
+        activeKernels() = selectKernels(std::min(level, getSupportedLevel()));
+    }
+
+    const char *getLevelName(SimdLevel level)
+    {
+        switch (level)
+        {
+        case SimdLevel::avx2:
+            return "AVX2";
+        case SimdLevel::sse41:
+            return "SSE4.1";
+        default:
+            return "scalar";
+        }
+    }
+
+    size_t relaxRow(const int *weights, uint32_t count, int base, int from, int *scores, int *cameFrom,
+                    uint32_t *improved)
+    {
+        return activeKernels().relaxRow(weights, count, base, from, scores, cameFrom, improved);
+    }
+
+    int argmin(const int *values, uint32_t count)
+    {
+        return activeKernels().argmin(values, count);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// instruction sets the dense kernels come in, from slowest to fastest
+enum class SimdLevel
+{
+    scalar,
+    sse41,
+    avx2
+};
+
+// Kernels for searches on adjacency matrices, where every settled vertex scans
+// a whole row. Each kernel has a scalar, an SSE4.1 and an AVX2 version; the
+// best one the CPU supports is picked at startup from CPUID, so the binary
+// itself needs no -mavx2 and runs on any x86-64 (or other) CPU.
+namespace simd
+{
+    // best level the running CPU supports
+    SimdLevel getSupportedLevel();
+
+    SimdLevel getLevel();
+
+    // Switches the kernels, mainly for benchmarks. Levels above the supported
+    // one fall back to it. Not thread-safe against running searches.
+    void setLevel(SimdLevel level);
+
+    const char *getLevelName(SimdLevel level);
+
+    // Relaxes every edge from -> i of a matrix row: where weights[i] != 0 and
+    // base + weights[i] < scores[i], stores the new score and sets cameFrom[i]
+    // to "from". Writes the improved columns in increasing order to "improved",
+    // which must hold "count" entries, and returns how many there are.
+    size_t relaxRow(const int *weights, uint32_t count, int base, int from, int *scores, int *cameFrom,
+                    uint32_t *improved);
+
+    // first index of the smallest value, -1 when every value is INT_MAX
+    int argmin(const int *values, uint32_t count);
+}
@@ -0,0 +1,211 @@
+#include "spatial_index.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    uint64_t cellKey(int column, int row)
+    {
+        return static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32 | static_cast<uint32_t>(column);
+    }
+
+    int64_t squaredDistance(const Point &a, const Point &b)
+    {
+        int64_t dx = a.x - b.x;
+        int64_t dy = a.y - b.y;
+        return dx * dx + dy * dy;
+    }
+}
+
+SpatialIndex::SpatialIndex(int cellSize) : cellSize(cellSize)
+{
+    if (cellSize <= 0)
+        throw std::invalid_argument("Cell size must be positive");
+}
+
+int SpatialIndex::cellOf(int coordinate) const
+{
+    // rounds down for negative coordinates too
+    int cell = coordinate / cellSize;
+    return coordinate % cellSize < 0 ? cell - 1 : cell;
+}
+
+const std::vector<SpatialIndex::Entry> *SpatialIndex::findCell(int column, int row) const
+{
+    if (column < minColumn || column > maxColumn || row < minRow || row > maxRow)
+        return nullptr;
+
+    auto cell = cells.find(cellKey(column, row));
+    return cell == cells.end() ? nullptr : &cell->second;
+}
+
+template <typename F>
+void SpatialIndex::scanRing(int column, int row, int ring, F f) const
+{
+    auto scan = [&](int x, int y)
+    {
+        if (const std::vector<Entry> *cell = findCell(x, y))
+        {
+            for (const Entry &entry : *cell)
+            {
+                f(entry);
+            }
+        }
+    };
+
+    if (ring == 0)
+    {
+        scan(column, row);
+        return;
+    }
+    for (int i = -ring; i <= ring; i++)
+    {
+        scan(column + i, row - ring);
+        scan(column + i, row + ring);
+    }
+    for (int i = -ring + 1; i <= ring - 1; i++)
+    {
+        scan(column - ring, row + i);
+        scan(column + ring, row + i);
+    }
+}
+
+size_t SpatialIndex::getMemoryBytes() const
+{
+    // every hash node holds the key, the cell vector and a next pointer
+    size_t bytes = cells.bucket_count() * sizeof(void *) +
+                   cells.size() * (sizeof(std::pair<const uint64_t, std::vector<Entry>>) + sizeof(void *));
+    for (const auto &cell : cells)
+    {
+        bytes += cell.second.capacity() * sizeof(Entry);
+    }
+    return bytes;
+}
+
+void SpatialIndex::clear()
+{
+    cells.clear();
+    size = 0;
+    minColumn = minRow = 0;
+    maxColumn = maxRow = -1;
+}
+
+void SpatialIndex::insert(uint32_t vertex, const Point &position)
+{
+    int column = cellOf(position.x);
+    int row = cellOf(position.y);
+
+    if (size == 0)
+    {
+        minColumn = maxColumn = column;
+        minRow = maxRow = row;
+    }
+    minColumn = std::min(minColumn, column);
+    maxColumn = std::max(maxColumn, column);
+    minRow = std::min(minRow, row);
+    maxRow = std::max(maxRow, row);
+
+    cells[cellKey(column, row)].push_back({position, vertex});
+    size++;
+}
+
+int SpatialIndex::nearest(const Point &position, int maxDistance) const
+{
+    if (size == 0)
+        return -1;
+
+    const int column = cellOf(position.x);
+    const int row = cellOf(position.y);
+    // rings beyond this one lie entirely outside the occupied cells
+    const int lastRing = std::max(std::max(std::abs(column - minColumn), std::abs(column - maxColumn)),
+                                  std::max(std::abs(row - minRow), std::abs(row - maxRow)));
+
+    int best = -1;
+    int64_t bestDistance = static_cast<int64_t>(maxDistance) * maxDistance;
+
+    for (int ring = 0; ring <= lastRing; ring++)
+    {
+        scanRing(column, row, ring, [&](const Entry &entry)
+        {
+            int64_t distance = squaredDistance(entry.position, position);
+            if (distance < bestDistance || (distance == bestDistance && (best == -1 || entry.vertex < static_cast<uint32_t>(best))))
+            {
+                bestDistance = distance;
+                best = entry.vertex;
+            }
+        });
+
+        // every vertex in a later ring is at least this far away
+        int64_t reach = static_cast<int64_t>(ring) * cellSize;
+        if (reach * reach > bestDistance)
+            break;
+    }
+
+    return best;
+}
+
+void SpatialIndex::kNearest(const Point &position, unsigned k, std::vector<uint32_t> &result) const
+{
+    result.clear();
+    if (size == 0 || k == 0)
+        return;
+
+    const int column = cellOf(position.x);
+    const int row = cellOf(position.y);
+    const int lastRing = std::max(std::max(std::abs(column - minColumn), std::abs(column - maxColumn)),
+                                  std::max(std::abs(row - minRow), std::abs(row - maxRow)));
+
+    // closest first, ties by id
+    std::vector<std::pair<int64_t, uint32_t>> candidates;
+
+    for (int ring = 0; ring <= lastRing; ring++)
+    {
+        scanRing(column, row, ring, [&](const Entry &entry)
+        {
+            std::pair<int64_t, uint32_t> candidate(squaredDistance(entry.position, position), entry.vertex);
+            if (candidates.size() == k && !(candidate < candidates.back()))
+                return;
+            if (candidates.size() == k)
+                candidates.pop_back();
+            candidates.insert(std::upper_bound(candidates.begin(), candidates.end(), candidate), candidate);
+        });
+
+        int64_t reach = static_cast<int64_t>(ring) * cellSize;
+        if (candidates.size() == k && reach * reach > candidates.back().first)
+            break;
+    }
+
+    for (const auto &candidate : candidates)
+    {
+        result.push_back(candidate.second);
+    }
+}
+
+void SpatialIndex::withinRadius(const Point &position, int radius, std::vector<uint32_t> &result) const
+{
+    result.clear();
+    if (size == 0 || radius < 0)
+        return;
+
+    const int64_t limit = static_cast<int64_t>(radius) * radius;
+    const int firstColumn = std::max(cellOf(position.x - radius), minColumn);
+    const int lastColumn = std::min(cellOf(position.x + radius), maxColumn);
+    const int firstRow = std::max(cellOf(position.y - radius), minRow);
+    const int lastRow = std::min(cellOf(position.y + radius), maxRow);
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        for (int column = firstColumn; column <= lastColumn; column++)
+        {
+            const std::vector<Entry> *cell = findCell(column, row);
+            if (!cell)
+                continue;
+
+            for (const Entry &entry : *cell)
+            {
+                if (squaredDistance(entry.position, position) <= limit)
+                    result.push_back(entry.vertex);
+            }
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "geometry.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// how far from a vertex a click still selects it, in pixels
+const int SNAP_DISTANCE = 20;
+
+// Hash grid over vertex coordinates for snapping positions to a graph.
+//
+// The plane is cut into square cells and every non-empty cell keeps the
+// vertices inside it, so a lookup only visits the cells around the query
+// instead of every vertex. Cells are hashed, so coordinates are unbounded and
+// inserting a vertex is O(1); graphs update their index in addVertex.
+class SpatialIndex
+{
+private:
+    struct Entry
+    {
+        Point position;
+        uint32_t vertex;
+    };
+
+    int cellSize;
+    std::unordered_map<uint64_t, std::vector<Entry>> cells;
+    size_t size = 0;
+    // bounding box of the occupied cells, limits how far the searches look
+    int minColumn = 0, maxColumn = -1;
+    int minRow = 0, maxRow = -1;
+
+    int cellOf(int coordinate) const;
+
+    const std::vector<Entry> *findCell(int column, int row) const;
+
+    // calls f(entry) for every vertex in the cells at Chebyshev distance "ring"
+    // around (column, row)
+    template <typename F>
+    void scanRing(int column, int row, int ring, F f) const;
+
+public:
+    explicit SpatialIndex(int cellSize = 32);
+
+    size_t getSize() const
+    {
+        return size;
+    }
+
+    // bytes held by the cells and the hash table, an estimate of the node
+    // overhead included
+    size_t getMemoryBytes() const;
+
+    void clear();
+
+    void insert(uint32_t vertex, const Point &position);
+
+    // Nearest vertex to "position", ties going to the lower id. Returns -1
+    // when no vertex lies within "maxDistance".
+    int nearest(const Point &position, int maxDistance = INT32_MAX) const;
+
+    // the (up to) k nearest vertices, closest first
+    void kNearest(const Point &position, unsigned k, std::vector<uint32_t> &result) const;
+
+    // every vertex at distance <= radius, in no particular order
+    void withinRadius(const Point &position, int radius, std::vector<uint32_t> &result) const;
+};
@@ -0,0 +1,90 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0)
+        threadCount = 1;
+
+    // the calling thread of run() is worker 0
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+unsigned ThreadPool::getThreadCount() const
+{
+    return threads.size() + 1;
+}
+
+void ThreadPool::execute(unsigned workerIndex)
+{
+    try
+    {
+        (*task)(workerIndex);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error)
+            error = std::current_exception();
+    }
+}
+
+void ThreadPool::workerLoop(unsigned workerIndex)
+{
+    uint64_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+
+        execute(workerIndex);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--running == 0)
+            finished.notify_one();
+    }
+}
+
+void ThreadPool::run(const std::function<void(unsigned)> &work)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &work;
+        error = nullptr;
+        running = threads.size();
+        generation++;
+    }
+    wakeUp.notify_all();
+
+    execute(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return running == 0; });
+    task = nullptr;
+
+    if (error)
+        std::rethrow_exception(error);
+}
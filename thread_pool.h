@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for fork-join parallel sections.
+//
+// run() hands the same task to every worker, with the calling thread acting as
+// worker 0, and returns once all of them are done. Threads are created once and
+// reused, so a parallel section costs a wake-up instead of a thread spawn.
+class ThreadPool
+{
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable finished;
+    const std::function<void(unsigned)> *task = nullptr;
+    uint64_t generation = 0;
+    unsigned running = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+
+    void workerLoop(unsigned workerIndex);
+    void execute(unsigned workerIndex);
+
+public:
+    // 0 threads means one per hardware thread
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned getThreadCount() const;
+
+    // calls task(workerIndex) once on every worker and waits for all of them,
+    // rethrows the first exception thrown by a worker
+    void run(const std::function<void(unsigned)> &task);
+};
+
+// Contiguous range of work items that its owner consumes from the front while
+// idle workers steal halves from the back, both lock-free.
+class WorkRange
+{
+private:
+    // begin in the low 32 bits, end in the high 32 bits
+    std::atomic<uint64_t> bounds{0};
+
+    static uint64_t pack(uint32_t begin, uint32_t end)
+    {
+        return static_cast<uint64_t>(end) << 32 | begin;
+    }
+
+public:
+    void assign(uint32_t begin, uint32_t end)
+    {
+        bounds.store(pack(begin, end));
+    }
+
+    // takes up to "chunk" items from the front
+    bool takeFront(uint32_t chunk, uint32_t &begin, uint32_t &end)
+    {
+        uint64_t current = bounds.load();
+        while (true)
+        {
+            uint32_t first = current, last = current >> 32;
+            if (first >= last)
+                return false;
+
+            uint32_t taken = last - first < chunk ? last : first + chunk;
+            if (bounds.compare_exchange_weak(current, pack(taken, last)))
+            {
+                begin = first;
+                end = taken;
+                return true;
+            }
+        }
+    }
+
+    // takes the back half of the remaining items
+    bool stealBack(uint32_t &begin, uint32_t &end)
+    {
+        uint64_t current = bounds.load();
+        while (true)
+        {
+            uint32_t first = current, last = current >> 32;
+            if (first >= last)
+                return false;
+
+            uint32_t middle = first + (last - first) / 2;
+            if (bounds.compare_exchange_weak(current, pack(first, middle)))
+            {
+                begin = middle;
+                end = last;
+                return true;
+            }
+        }
+    }
+};
+
+// Reusable barrier for the workers of one ThreadPool::run call: wait() returns
+// once all "count" workers have reached it. It spins with yield, since the
+// phases it separates are short; a worker that throws between two waits leaves
+// the others spinning, so the code between them must not throw.
+class SpinBarrier
+{
+private:
+    const unsigned count;
+    std::atomic<unsigned> waiting{0};
+    std::atomic<unsigned> generation{0};
+
+public:
+    explicit SpinBarrier(unsigned count) : count(count)
+    {
+    }
+
+    void wait()
+    {
+        const unsigned current = generation.load();
+        if (waiting.fetch_add(1) + 1 == count)
+        {
+            // the last worker opens the barrier for the others
+            waiting.store(0);
+            generation.fetch_add(1);
+            return;
+        }
+
+        while (generation.load() == current)
+        {
+            std::this_thread::yield();
+        }
+    }
+};
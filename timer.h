@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Stopwatch over the steady clock; tick returns the time since start or the
+// previous tick and restarts the measurement.
+class Timer
+{
+private:
+    std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+
+    template <typename Unit>
+    uint64_t tickIn()
+    {
+        auto end = std::chrono::steady_clock::now();
+
+        auto duration = std::chrono::duration_cast<Unit>(end - m_start).count();
+        m_start = end;
+
+        return duration;
+    }
+
+public:
+    void start()
+    {
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    // microseconds
+    uint64_t tick()
+    {
+        return tickIn<std::chrono::microseconds>();
+    }
+
+    uint64_t tickNanoseconds()
+    {
+        return tickIn<std::chrono::nanoseconds>();
+    }
+};
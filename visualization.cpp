@@ -0,0 +1,56 @@
+#include "visualization.h"
+
+namespace visualization
+{
+    void setTraceColor(size_t index, size_t count)
+    {
+        const int warmth = index * 0xFF / count;
+        helper::setColor(warmth, 0xC0 - warmth / 2, 0xFF - warmth);
+    }
+
+    void draw(const GridGraph &grid)
+    {
+        const int cellSize = grid.getCellSize();
+
+        helper::setColor(0x40, 0x40, 0x40);
+        for (uint32_t y = 0; y < grid.getHeight(); y++)
+        {
+            for (uint32_t x = 0; x < grid.getWidth(); x++)
+            {
+                if (!grid.isWalkable(x, y))
+                    helper::drawRect(x * cellSize, y * cellSize, cellSize, cellSize);
+            }
+        }
+    }
+
+    void drawPath(const GridGraph &grid, const std::vector<int> &path)
+    {
+        const int width = grid.getWidth();
+        const int cellSize = grid.getCellSize();
+        const int half = cellSize / 2;
+
+        helper::setColor(0x00, 0x00, 0xFF);
+        for (size_t i = 1; i < path.size(); i++)
+        {
+            int x1 = path[i - 1] % width * cellSize + half;
+            int y1 = path[i - 1] / width * cellSize + half;
+            int x2 = path[i] % width * cellSize + half;
+            int y2 = path[i] / width * cellSize + half;
+            helper::drawLine(x1, y1, x2, y2);
+        }
+    }
+
+    void drawExpanded(const GridGraph &grid, const std::vector<int> &trace)
+    {
+        const int width = grid.getWidth();
+        const int cellSize = grid.getCellSize();
+        const int margin = cellSize / 4;
+
+        for (size_t i = 0; i < trace.size(); i++)
+        {
+            setTraceColor(i, trace.size());
+            helper::drawRect(trace[i] % width * cellSize + margin, trace[i] / width * cellSize + margin,
+                             cellSize - 2 * margin, cellSize - 2 * margin);
+        }
+    }
+}
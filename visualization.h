@@ -0,0 +1,69 @@
+#pragma once
+
+#include "grid_graph.h"
+#include "helper.h"
+#include <cstddef>
+#include <vector>
+
+// SDL rendering of the graphs, built as its own library on top of the core so
+// that the graphs and searches do not depend on a display stack. Everything is
+// drawn in window pixels with the renderer set up by helper::init.
+namespace visualization
+{
+    // sets the color of step "index" of "count" in an expansion trace, from
+    // cold (settled first) to warm (settled last)
+    void setTraceColor(size_t index, size_t count);
+
+    // vertices as filled circles and edges as lines, in the current color;
+    // works for any graph with getVertexCount/getCoordinate/forEachNeighbor
+    template <typename G>
+    void draw(const G &g)
+    {
+        for (uint32_t i = 0; i < g.getVertexCount(); i++)
+        {
+            const Point &p = g.getCoordinate(i);
+            helper::drawFilledCircle(p.x, p.y, 10);
+        }
+
+        for (uint32_t i = 0; i < g.getVertexCount(); i++)
+        {
+            const Point &from = g.getCoordinate(i);
+            g.forEachNeighbor(i, [&](int neighbor, int)
+            {
+                const Point &to = g.getCoordinate(neighbor);
+                helper::drawLine(from.x, from.y, to.x, to.y);
+            });
+        }
+    }
+
+    template <typename G>
+    void drawPath(const G &g, const std::vector<int> &path)
+    {
+        helper::setColor(0x00, 0x00, 0xFF);
+        for (size_t i = 1; i < path.size(); i++)
+        {
+            const Point &from = g.getCoordinate(path[i - 1]);
+            const Point &to = g.getCoordinate(path[i]);
+            helper::drawLine(from.x, from.y, to.x, to.y);
+        }
+    }
+
+    // the vertices of an expansion trace, see SearchWorkspace::trace
+    template <typename G>
+    void drawExpanded(const G &g, const std::vector<int> &trace)
+    {
+        for (size_t i = 0; i < trace.size(); i++)
+        {
+            setTraceColor(i, trace.size());
+            const Point &p = g.getCoordinate(trace[i]);
+            helper::drawFilledCircle(p.x, p.y, 6);
+        }
+    }
+
+    // grid coordinates are in cost units, so grids are drawn cell by cell
+    void draw(const GridGraph &grid);
+
+    void drawPath(const GridGraph &grid, const std::vector<int> &path);
+
+    void drawExpanded(const GridGraph &grid, const std::vector<int> &trace);
+}